@@ -0,0 +1,97 @@
+#include "BenchmarkFramework.h"
+
+#include <string>
+
+#include "..\Headers\AssetManager.h"
+
+// Looks entities up by name the way scripts and the editor do. The scan walks
+// the entity list comparing names, the index hashes straight to the entity.
+BENCHMARK(AssetNameLookupVersusLinearScan)
+{
+	const int entityCount = 10000;
+	const int lookups = 1000;
+	const int runs = 20;
+
+	AssetManager& assetManager = AssetManager::GetInstance();
+	std::vector<std::string> names;
+	for (int i = 0; i < entityCount; i++) {
+		names.push_back("Entity " + std::to_string(i));
+		assetManager.CreateGameEntity(names.back());
+	}
+
+	// Spread through the list, so the scan averages about half of it
+	std::vector<std::string> targets;
+	for (int i = 0; i < lookups; i++) {
+		targets.push_back(names[(i * 7919) % entityCount]);
+	}
+
+	BenchmarkTimer scanning;
+	BenchmarkTimer indexed;
+	BenchmarkTimer rebuilding;
+	for (int run = 0; run < runs; run++) {
+		size_t found = 0;
+
+		scanning.Start();
+		for (const std::string& target : targets) {
+			size_t count = assetManager.GetGameEntityArraySize();
+			for (size_t i = 0; i < count; i++) {
+				if (assetManager.GetGameEntityAtID((int)i)->GetName() == target) {
+					found++;
+					break;
+				}
+			}
+		}
+		scanning.Stop(lookups);
+
+		// Renaming an entity invalidates the entity index, so the next lookup rebuilds it.
+		// Setting the same name again does nothing, so it goes away and back.
+		assetManager.GetGameEntityAtID(run)->SetName("Renamed");
+		assetManager.GetGameEntityAtID(run)->SetName(names[run]);
+		rebuilding.Start();
+		found += assetManager.GetGameEntityByName(targets[0]) != nullptr;
+		rebuilding.Stop();
+
+		indexed.Start();
+		for (const std::string& target : targets) {
+			found += assetManager.GetGameEntityByName(target) != nullptr;
+		}
+		indexed.Stop(lookups);
+
+		benchmarkSink = benchmarkSink + found;
+	}
+
+	scanning.Report("Linear scan by name, 10k entities, per lookup");
+	indexed.Report("GetGameEntityByName, same entities, per lookup");
+	rebuilding.Report("First lookup after a rename, rebuilding the index");
+}
+
+// Scripts often create an entity and look it up straight away. Appends are
+// indexed incrementally, so each lookup should only add the new entity.
+BENCHMARK(AssetNameLookupInterleavedWithCreation)
+{
+	const int entityCount = 10000;
+	const int runs = 5;
+
+	AssetManager& assetManager = AssetManager::GetInstance();
+	std::vector<std::string> names;
+	for (int i = 0; i < entityCount; i++) {
+		names.push_back("Entity " + std::to_string(i));
+	}
+
+	BenchmarkTimer interleaved;
+	for (int run = 0; run < runs; run++) {
+		size_t found = 0;
+
+		interleaved.Start();
+		for (const std::string& name : names) {
+			assetManager.CreateGameEntity(name);
+			found += assetManager.GetGameEntityByName(name) != nullptr;
+		}
+		interleaved.Stop();
+
+		assetManager.CleanAllEntities();
+		benchmarkSink = benchmarkSink + found;
+	}
+
+	interleaved.Report("10k creations, each followed by a lookup");
+}
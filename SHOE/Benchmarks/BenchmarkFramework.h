@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Minimal benchmark runner. Each BENCHMARK registers itself before main runs,
+// times what it measures with BenchmarkTimers and prints one line per result.
+// Run the Release configuration: Debug is unoptimized, and some component
+// event handlers print on every call there.
+
+struct BenchmarkCase
+{
+	const char* name;
+	void (*run)();
+};
+
+std::vector<BenchmarkCase>& GetBenchmarks();
+
+struct BenchmarkRegistration
+{
+	BenchmarkRegistration(const char* name, void (*run)()) { GetBenchmarks().push_back(BenchmarkCase{ name, run }); }
+};
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static BenchmarkRegistration name##Registration(#name, name); \
+	static void name()
+
+// Gives new MeshRenderers a cube to start with, made on a WARP device so no GPU or window is needed
+void SetBenchmarkMeshDefaults();
+
+// Written by benchmarks so the compiler can't drop the work being timed
+extern volatile size_t benchmarkSink;
+
+/// <summary>
+/// Adds up the time between each Start and Stop, so setup between runs stays untimed.
+/// Operations too quick to time one by one can be timed in batches, passing
+/// the batch size to Stop, and are reported per operation.
+/// </summary>
+class BenchmarkTimer
+{
+public:
+	void Start() { begin = std::chrono::steady_clock::now(); }
+	void Stop(int operations = 1) { total += std::chrono::steady_clock::now() - begin; runs += operations; }
+
+	double GetMeanMicroseconds() const {
+		return runs == 0 ? 0.0 : std::chrono::duration<double, std::micro>(total).count() / runs;
+	}
+
+	void Report(const char* label) const { printf("    %-52s %12.2f us\n", label, GetMeanMicroseconds()); }
+
+private:
+	std::chrono::steady_clock::time_point begin;
+	std::chrono::steady_clock::duration total = {};
+	int runs = 0;
+};
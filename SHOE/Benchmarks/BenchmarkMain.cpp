@@ -0,0 +1,61 @@
+#include "BenchmarkFramework.h"
+
+#include <cstring>
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\MeshRenderer.h"
+
+volatile size_t benchmarkSink = 0;
+
+std::vector<BenchmarkCase>& GetBenchmarks()
+{
+	// Function local so registrations from any file can run first
+	static std::vector<BenchmarkCase> benchmarks;
+	return benchmarks;
+}
+
+void SetBenchmarkMeshDefaults()
+{
+	static std::shared_ptr<Mesh> cube;
+	if (cube != nullptr) return;
+
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, 0, 0, nullptr, 0, D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, nullptr);
+
+	Vertex vertices[8] = {};
+	for (int i = 0; i < 8; i++) {
+		vertices[i].Position = DirectX::XMFLOAT3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+		vertices[i].normal = vertices[i].Position;
+	}
+	unsigned int indices[36] = {
+		0, 2, 3, 0, 3, 1,
+		4, 5, 7, 4, 7, 6,
+		0, 4, 6, 0, 6, 2,
+		1, 3, 7, 1, 7, 5,
+		0, 1, 5, 0, 5, 4,
+		2, 6, 7, 2, 7, 3
+	};
+
+	cube = std::make_shared<Mesh>(vertices, 8, indices, 36, device, "BenchmarkCube");
+	MeshRenderer::SetDefaults(cube, nullptr);
+}
+
+// --------------------------------------------------------
+// Runs every registered benchmark, or only those whose names
+// contain the first argument. Entities a benchmark leaves
+// behind are released before the next one runs.
+// --------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	for (const BenchmarkCase& benchmark : GetBenchmarks()) {
+		if (filter != nullptr && strstr(benchmark.name, filter) == nullptr) continue;
+
+		printf("%s\n", benchmark.name);
+		benchmark.run();
+		AssetManager::GetInstance().CleanAllEntities();
+	}
+
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "BenchmarkFramework.h"
+
+#include <cmath>
+#include <random>
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\CollisionManager.h"
+#include "..\Headers\TransformHierarchy.h"
+
+using namespace DirectX;
+
+// Colliders per cubic unit, so larger scenes spread out instead of piling up
+static const float colliderDensity = 0.05f;
+
+// Places a collider's entity somewhere random in the scene, turned at random
+static void Scatter(const std::shared_ptr<Transform>& transform, std::mt19937& random, float side)
+{
+	std::uniform_real_distribution<float> position(0.0f, side);
+	std::uniform_real_distribution<float> angle(0.0f, XM_2PI);
+	transform->SetPosition(position(random), position(random), position(random));
+	transform->SetRotation(XMFLOAT3(angle(random), angle(random), angle(random)));
+}
+
+// Brings every collider's box up to date, so neither timed pass pays for it
+static void RefreshBoxes()
+{
+	TransformHierarchy::UpdateWorldMatrices();
+	for (Collider& collider : ComponentManager::ViewEnabled<Collider>()) {
+		collider.GetOrientedBoundingBox();
+	}
+}
+
+// The loop CollisionManager ran before the broadphase: every enabled pair gets
+// the oriented box test. Only counts the hits, it sends no events.
+static size_t CountAllPairs()
+{
+	ComponentView<Collider> colliders = ComponentManager::ViewEnabled<Collider>();
+	size_t hits = 0;
+	for (size_t i = 0; i < colliders.size(); i++) {
+		if (!colliders.Includes(i)) continue;
+		BoundingOrientedBox a = colliders[i].GetOrientedBoundingBox();
+		for (size_t j = i + 1; j < colliders.size(); j++) {
+			if (!colliders.Includes(j)) continue;
+			if (colliders[i].IsTrigger() && colliders[j].IsTrigger()) continue;
+			if (a.Intersects(colliders[j].GetOrientedBoundingBox())) hits++;
+		}
+	}
+	return hits;
+}
+
+static void RunCollisionCase(int colliderCount, int movingPercent)
+{
+	const int frames = 10;
+
+	std::mt19937 random(colliderCount);
+	float side = cbrtf(colliderCount / colliderDensity);
+
+	std::vector<std::shared_ptr<Transform>> transforms;
+	for (int i = 0; i < colliderCount; i++) {
+		std::shared_ptr<GameEntity> entity = AssetManager::GetInstance().CreateGameEntity("Collider");
+		std::shared_ptr<Collider> collider = entity->AddComponent<Collider>();
+		if (i % 10 == 0) collider->SetIsTrigger(true);
+		Scatter(entity->GetTransform(), random, side);
+		transforms.push_back(entity->GetTransform());
+	}
+	Transform::NotifyChanges();
+	RefreshBoxes();
+	// Lets the sweep sort its list once before it's timed
+	CollisionManager::GetInstance().Update();
+
+	BenchmarkTimer allPairs;
+	BenchmarkTimer sweep;
+	for (int frame = 0; frame < frames; frame++) {
+		int moving = colliderCount * movingPercent / 100;
+		for (int i = 0; i < moving; i++) {
+			Scatter(transforms[(frame * moving + i) % colliderCount], random, side);
+		}
+		Transform::NotifyChanges();
+		RefreshBoxes();
+
+		allPairs.Start();
+		benchmarkSink = benchmarkSink + CountAllPairs();
+		allPairs.Stop();
+
+		sweep.Start();
+		CollisionManager::GetInstance().Update();
+		sweep.Stop();
+	}
+
+	char label[64];
+	snprintf(label, sizeof(label), "All pairs, %d colliders, %d%% moving", colliderCount, movingPercent);
+	allPairs.Report(label);
+	snprintf(label, sizeof(label), "CollisionManager::Update, same colliders");
+	sweep.Report(label);
+
+	AssetManager::GetInstance().CleanAllEntities();
+}
+
+// Random boxes at a constant density, a tenth of them triggers, with none,
+// some or all of them moved between frames. Each frame is run through the
+// old all pairs test and through the sweep and prune broadphase.
+BENCHMARK(CollisionSweepVersusAllPairs)
+{
+	RunCollisionCase(250, 0);
+	RunCollisionCase(250, 100);
+	RunCollisionCase(1000, 0);
+	RunCollisionCase(1000, 10);
+	RunCollisionCase(1000, 100);
+	RunCollisionCase(4000, 0);
+	RunCollisionCase(4000, 100);
+}
@@ -0,0 +1,46 @@
+#include "BenchmarkFramework.h"
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\Collider.h"
+#include "..\Headers\ComponentQuery.h"
+#include "..\Headers\MeshRenderer.h"
+
+// Pairs each MeshRenderer with its entity's Collider. The hand-written loop
+// goes through the entity and searches its components, the query checks the
+// entity's component mask and indexes straight into the Collider pool.
+BENCHMARK(ComponentQueryVersusGetComponent)
+{
+	const int entityCount = 10000;
+	const int runs = 100;
+
+	SetBenchmarkMeshDefaults();
+	for (int i = 0; i < entityCount; i++) {
+		std::shared_ptr<GameEntity> entity = AssetManager::GetInstance().CreateGameEntity("Renderer");
+		entity->AddComponent<MeshRenderer>();
+		if (i % 2 == 0) entity->AddComponent<Collider>();
+	}
+
+	BenchmarkTimer searching;
+	BenchmarkTimer querying;
+	for (int run = 0; run < runs; run++) {
+		size_t pairs = 0;
+
+		searching.Start();
+		for (MeshRenderer& renderer : ComponentManager::View<MeshRenderer>()) {
+			std::shared_ptr<Collider> collider = renderer.GetGameEntity()->GetComponent<Collider>();
+			if (collider != nullptr) pairs += collider->GetHandle().GetIndex();
+		}
+		searching.Stop();
+
+		querying.Start();
+		for (auto [renderer, collider] : ComponentManager::Query<MeshRenderer, Collider>()) {
+			pairs -= collider.GetHandle().GetIndex();
+		}
+		querying.Stop();
+
+		benchmarkSink = benchmarkSink + pairs;
+	}
+
+	searching.Report("View + GetComponent<Collider>, 10k entities, half paired");
+	querying.Report("Query<MeshRenderer, Collider>, same entities");
+}
@@ -0,0 +1,43 @@
+#include "BenchmarkFramework.h"
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\ComponentManager.h"
+#include "..\Headers\MeshRenderer.h"
+
+// Walks the enabled MeshRenderers the way per-frame callers do. GetAllEnabled
+// builds a vector of shared_ptrs each call, a view reads the pool in place.
+BENCHMARK(ComponentViewVersusGetAllEnabled)
+{
+	const int entityCount = 10000;
+	const int runs = 200;
+
+	SetBenchmarkMeshDefaults();
+	for (int i = 0; i < entityCount; i++) {
+		std::shared_ptr<MeshRenderer> renderer = AssetManager::GetInstance().CreateGameEntity("Renderer")->AddComponent<MeshRenderer>();
+		// A quarter disabled, spread through the pool
+		if (i % 4 == 3) renderer->SetEnabled(false);
+	}
+
+	BenchmarkTimer copying;
+	BenchmarkTimer viewing;
+	for (int run = 0; run < runs; run++) {
+		size_t visited = 0;
+
+		copying.Start();
+		for (const std::shared_ptr<MeshRenderer>& renderer : ComponentManager::GetAllEnabled<MeshRenderer>()) {
+			visited += renderer->GetHandle().GetIndex();
+		}
+		copying.Stop();
+
+		viewing.Start();
+		for (MeshRenderer& renderer : ComponentManager::ViewEnabled<MeshRenderer>()) {
+			visited -= renderer.GetHandle().GetIndex();
+		}
+		viewing.Stop();
+
+		benchmarkSink = benchmarkSink + visited;
+	}
+
+	copying.Report("GetAllEnabled, 10k MeshRenderers, 75% enabled");
+	viewing.Report("ViewEnabled, same renderers");
+}
@@ -0,0 +1,87 @@
+#include "BenchmarkFramework.h"
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\AudioResponse.h"
+#include "..\Headers\Collider.h"
+#include "..\Headers\Light.h"
+#include "..\Headers\MeshRenderer.h"
+
+// One frame's worth of entity events, sent to every entity
+static const EntityEventType frameEvents[] = { OnMove, OnTransform, OnParentTransform, InCollision, OnAudioPlay };
+
+// An entity's transform and components, read once so the unmasked loop
+// below pays only for dispatch, as GameEntity did before event masks
+struct UnmaskedEntity
+{
+	std::shared_ptr<GameEntity> entity;
+	std::shared_ptr<Transform> transform;
+	std::vector<std::shared_ptr<IComponent>> components;
+};
+
+// Sends the same events through the masked dispatch, which skips components
+// that don't handle them, and through the old loop that offered every event
+// to every enabled component
+BENCHMARK(MaskedEventDispatchVersusAllComponents)
+{
+	const int entityCount = 20000;
+	const int runs = 20;
+
+	AssetManager& assetManager = AssetManager::GetInstance();
+	SetBenchmarkMeshDefaults();
+
+	std::vector<UnmaskedEntity> unmasked;
+	for (int i = 0; i < entityCount; i++) {
+		std::shared_ptr<GameEntity> entity = assetManager.CreateGameEntity("Dispatch");
+		entity->AddComponent<MeshRenderer>();
+		if (i % 4 == 0) entity->AddComponent<Collider>();
+		// Lights stop at MAX_LIGHTS, so spread that many through the list
+		if (i % (entityCount / MAX_LIGHTS) == 0) entity->AddComponent<Light>();
+		if (i % 50 == 0) entity->AddComponent<AudioResponse>();
+
+		unmasked.push_back(UnmaskedEntity{ entity, entity->GetTransform(), entity->GetAllComponents() });
+	}
+
+	std::shared_ptr<GameEntity> other = assetManager.GetGameEntityAtID(0);
+	EntityEventMessage messages[] = {
+		EntityEventMessage(DirectX::XMFLOAT3(1.0f, 0.0f, 0.0f)),
+		EntityEventMessage(),
+		EntityEventMessage(other),
+		EntityEventMessage(other),
+		EntityEventMessage(AudioEventPacket("Benchmark", nullptr))
+	};
+	const int eventCount = sizeof(frameEvents) / sizeof(frameEvents[0]);
+
+	BenchmarkTimer everyComponent;
+	BenchmarkTimer masked;
+	for (int run = 0; run < runs; run++) {
+		size_t delivered = 0;
+
+		everyComponent.Start();
+		for (int e = 0; e < eventCount; e++) {
+			for (const UnmaskedEntity& target : unmasked) {
+				if (!target.entity->GetEnabled()) continue;
+
+				target.transform->ReceiveEvent(frameEvents[e], messages[e]);
+				for (size_t i = 0; i < target.components.size(); i++) {
+					std::shared_ptr<IComponent> component = target.components[i];
+					if (component->IsEnabled()) {
+						component->ReceiveEvent(frameEvents[e], messages[e]);
+						delivered++;
+					}
+				}
+			}
+		}
+		everyComponent.Stop();
+
+		masked.Start();
+		for (int e = 0; e < eventCount; e++) {
+			assetManager.BroadcastGlobalEntityEvent(frameEvents[e], messages[e]);
+		}
+		masked.Stop();
+
+		benchmarkSink = benchmarkSink + delivered;
+	}
+
+	everyComponent.Report("Every enabled component, 20k entities, 5 events");
+	masked.Report("BroadcastGlobalEntityEvent with event masks");
+}
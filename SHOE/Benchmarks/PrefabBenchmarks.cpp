@@ -0,0 +1,38 @@
+#include "BenchmarkFramework.h"
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\MeshRenderer.h"
+#include "..\Headers\Prefab.h"
+
+// Spawns a batch of renderers one entity at a time, then as one prefab
+// batch that reserves each pool once and starts the components together
+BENCHMARK(InstantiateManyVersusCreateGameEntity)
+{
+	const int entityCount = 10000;
+	const int runs = 10;
+
+	AssetManager& assetManager = AssetManager::GetInstance();
+	SetBenchmarkMeshDefaults();
+
+	Prefab prefab("Renderer");
+	prefab.AddComponent<MeshRenderer>();
+
+	BenchmarkTimer individually;
+	BenchmarkTimer batched;
+	for (int run = 0; run < runs; run++) {
+		individually.Start();
+		for (int i = 0; i < entityCount; i++) {
+			assetManager.CreateGameEntity("Renderer")->AddComponent<MeshRenderer>();
+		}
+		individually.Stop();
+		assetManager.CleanAllEntities();
+
+		batched.Start();
+		benchmarkSink = benchmarkSink + assetManager.InstantiateMany(prefab, entityCount).size();
+		batched.Stop();
+		assetManager.CleanAllEntities();
+	}
+
+	individually.Report("CreateGameEntity + AddComponent<MeshRenderer>, 10k");
+	batched.Report("InstantiateMany, same prefab");
+}
@@ -0,0 +1,49 @@
+#include "BenchmarkFramework.h"
+
+#include "..\Headers\AssetManager.h"
+
+using namespace DirectX;
+
+// Moves every root once a frame, one SetPosition per entity against one
+// SetLocalPositions call for all of them, each followed by the frame's
+// NotifyChanges so the OnTransform they queue is counted too
+BENCHMARK(SetLocalPositionsVersusSetPosition)
+{
+	const int rootCount = 10000;
+	const int runs = 100;
+
+	std::vector<std::shared_ptr<Transform>> transforms;
+	std::vector<ComponentHandle> handles;
+	for (int i = 0; i < rootCount; i++) {
+		std::shared_ptr<Transform> transform = AssetManager::GetInstance().CreateGameEntity("Root")->GetTransform();
+		transforms.push_back(transform);
+		handles.push_back(transform->GetHandle());
+	}
+
+	// Each pass moves every root to the other set, as setting a transform to where it is already does nothing
+	std::vector<XMFLOAT3> positions[2];
+	for (int i = 0; i < rootCount; i++) {
+		positions[0].push_back(XMFLOAT3((float)i, 0.0f, 0.0f));
+		positions[1].push_back(XMFLOAT3((float)i, 1.0f, 0.0f));
+	}
+
+	BenchmarkTimer individually;
+	BenchmarkTimer batched;
+	for (int run = 0; run < runs; run++) {
+		individually.Start();
+		for (int i = 0; i < rootCount; i++) {
+			transforms[i]->SetPosition(positions[0][i]);
+		}
+		Transform::NotifyChanges();
+		individually.Stop();
+
+		batched.Start();
+		Transform::SetLocalPositions(handles, positions[1]);
+		Transform::NotifyChanges();
+		batched.Stop();
+	}
+
+	benchmarkSink = benchmarkSink + handles.size();
+	individually.Report("SetPosition + NotifyChanges, 10k roots");
+	batched.Report("SetLocalPositions + NotifyChanges, same roots");
+}
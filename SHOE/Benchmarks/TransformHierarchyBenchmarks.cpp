@@ -0,0 +1,56 @@
+#include "BenchmarkFramework.h"
+
+#include <thread>
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\TransformHierarchy.h"
+
+// Moves every root, so the next pass rebuilds every world matrix
+static void DirtyRoots(const std::vector<std::shared_ptr<Transform>>& roots, float x)
+{
+	for (const std::shared_ptr<Transform>& root : roots) {
+		root->SetPosition(x, 0.0f, 0.0f);
+	}
+	Transform::NotifyChanges();
+}
+
+// Rebuilds a crowd's world matrices in one pass on this thread, then one
+// depth at a time in chunks across the SystemScheduler's workers
+BENCHMARK(TransformHierarchySerialVersusParallel)
+{
+	const int rootCount = 25000;
+	const int childrenPerRoot = 4;
+	const int runs = 20;
+
+	AssetManager& assetManager = AssetManager::GetInstance();
+	std::vector<std::shared_ptr<Transform>> roots;
+	for (int i = 0; i < rootCount; i++) {
+		std::shared_ptr<Transform> root = assetManager.CreateGameEntity("Root")->GetTransform();
+		for (int c = 0; c < childrenPerRoot; c++) {
+			root->AddChild(assetManager.CreateGameEntity("Child")->GetTransform());
+		}
+		roots.push_back(root);
+	}
+
+	// Sorts the slots by depth and starts the workers before anything is timed
+	TransformHierarchy::UpdateWorldMatricesParallel();
+
+	BenchmarkTimer serial;
+	BenchmarkTimer parallel;
+	for (int run = 0; run < runs; run++) {
+		DirtyRoots(roots, (float)run);
+		serial.Start();
+		TransformHierarchy::UpdateWorldMatricesSerial();
+		serial.Stop();
+
+		DirtyRoots(roots, (float)-run);
+		parallel.Start();
+		TransformHierarchy::UpdateWorldMatricesParallel();
+		parallel.Stop();
+	}
+
+	benchmarkSink = benchmarkSink + TransformHierarchy::GetCount();
+	printf("    %u transforms, %u hardware threads\n", TransformHierarchy::GetCount(), std::thread::hardware_concurrency());
+	serial.Report("UpdateWorldMatricesSerial, all dirty");
+	parallel.Report("UpdateWorldMatricesParallel, all dirty");
+}
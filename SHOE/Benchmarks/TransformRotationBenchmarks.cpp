@@ -0,0 +1,120 @@
+#include "BenchmarkFramework.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "..\Headers\AssetManager.h"
+#include "..\Headers\TransformHierarchy.h"
+
+using namespace DirectX;
+
+// Gives a transform fanOut children, and each of those fanOut more, depth levels down
+static void AddSubtree(const std::shared_ptr<Transform>& parent, int fanOut, int depth, std::vector<std::shared_ptr<Transform>>& all)
+{
+	if (depth == 0) return;
+	for (int i = 0; i < fanOut; i++) {
+		std::shared_ptr<Transform> child = AssetManager::GetInstance().CreateGameEntity("Child")->GetTransform();
+		child->SetPosition((float)i, 1.0f, 0.0f);
+		child->SetRotation(XMFLOAT3(0.1f * i, 0.2f, 0.0f));
+		parent->AddChild(child);
+		all.push_back(child);
+		AddSubtree(child, fanOut, depth - 1, all);
+	}
+}
+
+static void RotateRoots(const std::vector<std::shared_ptr<Transform>>& roots, float angle)
+{
+	XMFLOAT4 rotation;
+	XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(angle, angle * 0.5f, 0.0f));
+	for (const std::shared_ptr<Transform>& root : roots) {
+		root->SetRotation(rotation);
+	}
+	Transform::NotifyChanges();
+}
+
+// World rotation is composed from stored quaternions instead of decomposed
+// out of each world matrix. Times the paths that leans on: rebuilding a
+// rotated hierarchy, reading directions back, and reparenting.
+BENCHMARK(TransformRotationComposition)
+{
+	const int rootCount = 2000;
+	const int fanOut = 4;
+	const int depth = 3;
+	const int reparentCount = 1000;
+	const int runs = 10;
+
+	std::vector<std::shared_ptr<Transform>> roots;
+	std::vector<std::shared_ptr<Transform>> all;
+	for (int i = 0; i < rootCount; i++) {
+		std::shared_ptr<Transform> root = AssetManager::GetInstance().CreateGameEntity("Root")->GetTransform();
+		root->SetPosition((float)i, 0.0f, 0.0f);
+		roots.push_back(root);
+		all.push_back(root);
+		AddSubtree(root, fanOut, depth, all);
+	}
+	TransformHierarchy::UpdateWorldMatrices();
+
+	BenchmarkTimer passAndForward;
+	BenchmarkTimer passAlone;
+	BenchmarkTimer forwardOnly;
+	for (int run = 0; run < runs; run++) {
+		float sum = 0.0f;
+
+		RotateRoots(roots, 0.1f * run);
+		passAndForward.Start();
+		TransformHierarchy::UpdateWorldMatrices();
+		for (const std::shared_ptr<Transform>& transform : all) {
+			sum += transform->GetForward().z;
+		}
+		passAndForward.Stop();
+
+		RotateRoots(roots, -0.1f * run);
+		passAlone.Start();
+		TransformHierarchy::UpdateWorldMatrices();
+		passAlone.Stop();
+
+		forwardOnly.Start();
+		for (const std::shared_ptr<Transform>& transform : all) {
+			sum += transform->GetForward().z;
+		}
+		forwardOnly.Stop();
+
+		benchmarkSink = benchmarkSink + (size_t)sum;
+	}
+
+	// Moves leaves of the second root under the first and back again,
+	// checking they end up where they started
+	std::shared_ptr<Transform> home = roots[1]->GetChild(0)->GetChild(0);
+	std::shared_ptr<Transform> away = roots[0]->GetChild(0)->GetChild(0);
+	std::vector<std::shared_ptr<Transform>> leaves;
+	std::vector<XMFLOAT4X4> before;
+	for (unsigned int i = 0; i < home->GetChildCount(); i++) {
+		leaves.push_back(home->GetChild(i));
+		before.push_back(home->GetChild(i)->GetWorldMatrix());
+	}
+
+	BenchmarkTimer reparenting;
+	for (int round = 0; round < reparentCount; round++) {
+		reparenting.Start();
+		for (const std::shared_ptr<Transform>& leaf : leaves) {
+			leaf->SetParent(away);
+			leaf->SetParent(home);
+		}
+		reparenting.Stop((int)leaves.size() * 2);
+	}
+
+	float drift = 0.0f;
+	for (size_t i = 0; i < leaves.size(); i++) {
+		XMFLOAT4X4 after = leaves[i]->GetWorldMatrix();
+		for (int e = 0; e < 16; e++) {
+			drift = std::max<float>(drift, fabsf((&after._11)[e] - (&before[i]._11)[e]));
+		}
+	}
+
+	printf("    %u transforms\n", TransformHierarchy::GetCount());
+	passAndForward.Report("Every root rotated, pass + GetForward on all");
+	passAlone.Report("Every root rotated, pass alone");
+	forwardOnly.Report("GetForward on all, nothing moved");
+	reparenting.Report("SetParent, per reparent");
+	printf("    %-52s %12.2e\n", "World matrix drift after 1000 round trips", drift);
+}
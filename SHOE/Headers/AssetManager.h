@@ -8,6 +8,7 @@
 #include "Sky.h"
 #include "SimpleShader.h"
 #include "GameEntity.h"
+#include "ComponentTypeID.h"
 #include "ParticleSystem.h"
 #include "Terrain.h"
 #include "WICTextureLoader.h"
@@ -21,6 +22,8 @@
 #include <locale>
 #include <codecvt>
 #include "AudioHandler.h"
+#include "AssetNameIndex.h"
+#include "Prefab.h"
 #include <exception>
 #include "SpriteBatch.h"
 #include "Collider.h"
@@ -30,23 +33,6 @@
 
 #define RandomRange(min, max) (float)rand() / RAND_MAX * (max - min) + min
 
-enum ComponentTypes {
-	// While Transform is tracked here, it is often skipped or handled uniquely
-	// when assessing all components, as it cannot be removed or doubled
-	TRANSFORM,
-	MESH_RENDERER,
-	PARTICLE_SYSTEM,
-	COLLIDER,
-	TERRAIN,
-	LIGHT,
-	CAMERA,
-	NOCLIP_CHAR_CONTROLLER,
-	FLASHLIGHT_CONTROLLER,
-	AUDIO_RESPONSE_DEVICE,
-	// Must always be the final enum
-	COMPONENT_TYPE_COUNT
-};
-
 class AssetManager
 {
 #pragma region Singleton
@@ -132,6 +118,20 @@ private:
 	std::vector<FMOD::Sound*> globalSounds;
 	std::vector<std::shared_ptr<SHOEFont>> globalFonts;
 
+	// Name lookups for the lists above
+	AssetNameIndex<SimplePixelShader, ISimpleShader> pixelShaderIndex = AssetNameIndex<SimplePixelShader, ISimpleShader>(&pixelShaders);
+	AssetNameIndex<SimpleVertexShader, ISimpleShader> vertexShaderIndex = AssetNameIndex<SimpleVertexShader, ISimpleShader>(&vertexShaders);
+	AssetNameIndex<SimpleComputeShader, ISimpleShader> computeShaderIndex = AssetNameIndex<SimpleComputeShader, ISimpleShader>(&computeShaders);
+	AssetNameIndex<Sky> skyIndex = AssetNameIndex<Sky>(&skies);
+	AssetNameIndex<Mesh> meshIndex = AssetNameIndex<Mesh>(&globalMeshes);
+	AssetNameIndex<Texture> textureIndex = AssetNameIndex<Texture>(&globalTextures);
+	AssetNameIndex<Material> materialIndex = AssetNameIndex<Material>(&globalMaterials);
+	AssetNameIndex<GameEntity> entityIndex = AssetNameIndex<GameEntity>(&globalEntities);
+	AssetNameIndex<TerrainMaterial> terrainMaterialIndex = AssetNameIndex<TerrainMaterial>(&globalTerrainMaterials);
+	AssetNameIndex<SHOEFont> fontIndex = AssetNameIndex<SHOEFont>(&globalFonts, [](const std::shared_ptr<SHOEFont>& font) { return font->name; });
+
+	void InvalidateNameIndices();
+
 	std::shared_ptr<Camera> editingCamera;
 	std::shared_ptr<Camera> mainCamera;
 
@@ -194,6 +194,7 @@ public:
 	// Methods to create new entities
 	std::shared_ptr<GameEntity> CreateGameEntity(std::string name = "GameEntity");
 	std::shared_ptr<GameEntity> CreateGameEntity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> mat, std::string name = "GameEntity");
+	std::vector<std::shared_ptr<GameEntity>> InstantiateMany(const Prefab& prefab, size_t count, const std::vector<PrefabTransform>& transforms = {});
 
 	/// <summary>
 	/// Creates a new skybox object with the given texture.
@@ -325,6 +326,7 @@ public:
 
 	void RemoveGameEntity(std::string name);
 	void RemoveGameEntity(int id);
+	void RemoveGameEntities(const std::vector<std::shared_ptr<GameEntity>>& entities);
 	void RemoveSky(std::string name);
 	void RemoveSky(int id);
 	void RemoveVertexShader(std::string name);
@@ -343,25 +345,25 @@ public:
 
 	// Asset search-by-name methods
 
-	std::shared_ptr<GameEntity> GetGameEntityByName(std::string name);
-	std::shared_ptr<Sky> GetSkyByName(std::string name);
-	std::shared_ptr<SimpleVertexShader> GetVertexShaderByName(std::string name);
-	std::shared_ptr<SimplePixelShader> GetPixelShaderByName(std::string name);
-	std::shared_ptr<SimpleComputeShader> GetComputeShaderByName(std::string name);
-	std::shared_ptr<Mesh> GetMeshByName(std::string name);
-	std::shared_ptr<Texture> GetTextureByName(std::string name);
-	std::shared_ptr<Material> GetMaterialByName(std::string name);
-	std::shared_ptr<TerrainMaterial> GetTerrainMaterialByName(std::string name);
+	std::shared_ptr<GameEntity> GetGameEntityByName(std::string_view name);
+	std::shared_ptr<Sky> GetSkyByName(std::string_view name);
+	std::shared_ptr<SimpleVertexShader> GetVertexShaderByName(std::string_view name);
+	std::shared_ptr<SimplePixelShader> GetPixelShaderByName(std::string_view name);
+	std::shared_ptr<SimpleComputeShader> GetComputeShaderByName(std::string_view name);
+	std::shared_ptr<Mesh> GetMeshByName(std::string_view name);
+	std::shared_ptr<Texture> GetTextureByName(std::string_view name);
+	std::shared_ptr<Material> GetMaterialByName(std::string_view name);
+	std::shared_ptr<TerrainMaterial> GetTerrainMaterialByName(std::string_view name);
 	FMOD::Sound* GetSoundByName();
-	std::shared_ptr<SHOEFont> GetFontByName(std::string name);
-
-	int GetGameEntityIDByName(std::string name);
-	int GetSkyIDByName(std::string name);
-	int GetVertexShaderIDByName(std::string name);
-	int GetPixelShaderIDByName(std::string name);
-	int GetComputeShaderIDByName(std::string name);
-	int GetMeshIDByName(std::string name);
-	int GetMaterialIDByName(std::string name);
+	std::shared_ptr<SHOEFont> GetFontByName(std::string_view name);
+
+	int GetGameEntityIDByName(std::string_view name);
+	int GetSkyIDByName(std::string_view name);
+	int GetVertexShaderIDByName(std::string_view name);
+	int GetPixelShaderIDByName(std::string_view name);
+	int GetComputeShaderIDByName(std::string_view name);
+	int GetMeshIDByName(std::string_view name);
+	int GetMaterialIDByName(std::string_view name);
 	//int GetTerrainMaterialIDByName(std::string name);
 
 	// Relevant Get methods
@@ -392,7 +394,8 @@ public:
 	int GetPixelShaderIDByPointer(std::shared_ptr<SimplePixelShader> pixelPointer);
 	int GetVertexShaderIDByPointer(std::shared_ptr<SimpleVertexShader> vertexPointer);
 
-	void BroadcastGlobalEntityEvent(EntityEventType event, std::shared_ptr<void> message = nullptr);
+	void BroadcastGlobalEntityEvent(EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
+	void BroadcastGlobalEntityEvents(EntityEventType event, const std::vector<EntityEventMessage>& messages);
 
 	bool CompareFilePaths(const std::filesystem::path& path, const std::filesystem::path& base);
 
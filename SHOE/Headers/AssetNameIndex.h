@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Hashes anything string-like the same way, so name indices can be
+/// searched with a const char* or string_view without building a std::string
+/// </summary>
+struct AssetNameHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view name) const {
+		return std::hash<std::string_view>{}(name);
+	}
+};
+
+/// <summary>
+/// Rename tracking for one kind of asset.
+/// Assets don't know which list they live in, but each kind lives in its own,
+/// so renaming one bumps that kind's counter and only its index rebuilds on
+/// its next lookup.
+/// </summary>
+template <typename T>
+class AssetRenames
+{
+public:
+	static void Notify() { generation++; }
+	static unsigned int GetGeneration() { return generation; }
+
+private:
+	static inline unsigned int generation = 0;
+};
+
+/// <summary>
+/// Hash index from asset name to its position in one of the AssetManager lists.
+/// Mirrors the old linear searches: if names repeat, the first one wins.
+/// Appends are picked up incrementally, anything else that reorders or
+/// shrinks the list must call Invalidate().
+/// Renamed is the type whose SetName reports renames, for lists of a
+/// subclass that inherits SetName from a base.
+/// </summary>
+template <typename T, typename Renamed = T>
+class AssetNameIndex
+{
+public:
+	typedef std::string (*NameGetter)(const std::shared_ptr<T>& asset);
+
+	AssetNameIndex(const std::vector<std::shared_ptr<T>>* assets,
+				   NameGetter getName = [](const std::shared_ptr<T>& asset) { return asset->GetName(); })
+		: assets(assets), getName(getName) {}
+
+	/// <summary>
+	/// Finds the position of the first asset with a name
+	/// </summary>
+	/// <returns>The index into the list, or -1 if none match</returns>
+	int Find(std::string_view name) {
+		Refresh();
+		auto found = ids.find(name);
+		return found == ids.end() ? -1 : found->second;
+	}
+
+	/// <summary>
+	/// Forces a full rebuild on the next lookup
+	/// </summary>
+	void Invalidate() {
+		stale = true;
+	}
+
+private:
+	void Refresh() {
+		unsigned int renameGeneration = AssetRenames<Renamed>::GetGeneration();
+		if (stale || generation != renameGeneration || indexedCount > assets->size()) {
+			ids.clear();
+			indexedCount = 0;
+			generation = renameGeneration;
+			stale = false;
+		}
+
+		for (; indexedCount < assets->size(); indexedCount++) {
+			ids.try_emplace(getName((*assets)[indexedCount]), (int)indexedCount);
+		}
+	}
+
+	const std::vector<std::shared_ptr<T>>* assets;
+	NameGetter getName;
+
+	std::unordered_map<std::string, int, AssetNameHash, std::equal_to<>> ids;
+	size_t indexedCount = 0;
+	unsigned int generation = 0;
+	bool stale = true;
+};
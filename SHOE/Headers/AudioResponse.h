@@ -1,5 +1,6 @@
 #pragma once
 #include "IComponent.h"
+#include "ComponentTypeID.h"
 
 enum class AudioEventTrigger {
 	FrequencyAbove,
@@ -38,6 +39,10 @@ enum class AudioResponseMathModifier {
 class AudioResponse : public IComponent
 {
 public:
+	// Access declared to the SystemScheduler, Light is covered by TransformWriteAccess
+	typedef ComponentAccess<> Reads;
+	typedef TransformWriteAccess Writes;
+
 	std::string audioName;
 	AudioEventTrigger trigger;
 	float triggerComparison;
@@ -49,15 +54,17 @@ public:
 	//void SetLinkedSound(FMOD::Sound* sound);
 	void SetLinkedSound(FMOD::Channel* channel);
 
-private:
-	bool canTrigger;
-
-	void Start() override;
+protected:
 	void Update() override;
 	void EditingUpdate() override;
 	void OnAudioPlay(AudioEventPacket audio) override;
 	void OnAudioPause(AudioEventPacket audio) override;
 
+private:
+	bool canTrigger;
+
+	void Start() override;
+
 	bool IsTriggered();
 	void TriggerResponse();
 
@@ -42,6 +42,7 @@ private:
 	float aspectRatio;
 	bool isPerspective;
 
+protected:
 	void OnTransform() override;
 	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
 };
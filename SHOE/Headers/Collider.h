@@ -27,21 +27,23 @@ public:
 	void SetIsTrigger(bool _isTrigger);
 	void SetVisible(bool _isVisible);
 
-private:
-	void RegenerateBoundingBox();
-
-	void Start() override;
+protected:
 	void OnCollisionEnter(std::shared_ptr<GameEntity> other) override;
 	void OnTriggerEnter(std::shared_ptr<GameEntity> other) override;
 	void InCollision(std::shared_ptr<GameEntity> other) override;
 	void InTrigger(std::shared_ptr<GameEntity> other) override;
 	void OnCollisionExit(std::shared_ptr<GameEntity> other) override;
 	void OnTriggerExit(std::shared_ptr<GameEntity> other) override;
-	void OnTransform() override;
-	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
+
+private:
+	void RegenerateBoundingBox();
+
+	void Start() override;
 
 	std::shared_ptr<Transform> offset;
 	DirectX::BoundingOrientedBox obb_;
+	// The offset's world version obb_ was built from
+	uint32_t obbVersion;
 
 	bool isTrigger_;
 	bool isVisible_;
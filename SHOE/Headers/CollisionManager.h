@@ -1,16 +1,34 @@
 ﻿#pragma once
 
 #include "Collider.h"
+#include "ComponentView.h"
 #include <vector>
 
 struct Collision {
 	std::shared_ptr<Collider> a;
 	std::shared_ptr<Collider> b;
+	// Handles when the collision was registered, since a freed collider's slot can be reused
+	ComponentHandle aHandle;
+	ComponentHandle bHandle;
 	friend bool operator==(const Collision& lhs, const Collision& rhs) { 
 		return lhs.a == rhs.a && lhs.b == lhs.b || lhs.a == rhs.b && lhs.b == lhs.a;
 	}
 };
 
+// A collider's world AABB on the axis the broadphase sweeps along
+struct SweepEntry {
+	float min;
+	float max;
+	// Position of the collider in the enabled collider view
+	uint32_t collider;
+};
+
+/// <summary>
+/// Finds overlapping colliders each frame and sends the collision and trigger events.
+/// A sweep and prune over world AABBs picks out the pairs that could touch, and only
+/// those get the exact oriented box test. The sweep list is kept sorted between frames,
+/// so it only needs to fix up colliders that passed each other.
+/// </summary>
 class CollisionManager
 {
 #pragma region Singleton
@@ -41,9 +59,25 @@ public:
 private:
 	void RegisterColliderCollision(std::shared_ptr<Collider> a, std::shared_ptr<Collider> b);
 	void RegisterTriggerCollision(std::shared_ptr<Collider> collider, std::shared_ptr<Collider> trigger);
+	void FindCandidatePairs(ComponentView<Collider>& colliders);
 
 	std::vector<Collision> activeCollisions;
 	std::vector<Collision> activeTriggers;
 	std::vector<Collision> lastFrameCollisions;
 	std::vector<Collision> lastFrameTriggers;
+
+	// Broadphase state, kept between frames
+	std::vector<SweepEntry> sweepEntries;
+	// 0, 1 or 2 for x, y or z, whichever the colliders are most spread out along
+	int sweepAxis;
+	// World AABB of each collider, by view position
+	std::vector<DirectX::XMFLOAT3> sweepMins;
+	std::vector<DirectX::XMFLOAT3> sweepMaxs;
+	// Whether each view position already has a sweep entry
+	std::vector<uint8_t> sweepPresent;
+	// Handle of each collider, by view position. Handlers can free colliders
+	// while pairs are being tested, after which a position may name another one.
+	std::vector<ComponentHandle> sweepHandles;
+	// View positions of each pair to test, lower in the high half, in ascending order
+	std::vector<uint64_t> candidatePairs;
 };
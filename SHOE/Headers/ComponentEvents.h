@@ -0,0 +1,59 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+
+#include "IComponent.h"
+
+/// <summary>
+/// Derives from a component so its protected event hook overrides are visible.
+/// Each hook's member pointer type is an IComponent member pointer unless
+/// T, or a class between T and IComponent, overrides that hook.
+/// </summary>
+template <typename T>
+struct ComponentEventProbe : T
+{
+	typedef void (IComponent::*Hook)();
+	typedef void (IComponent::*VectorHook)(DirectX::XMFLOAT3);
+	typedef void (IComponent::*EntityHook)(std::shared_ptr<GameEntity>);
+	typedef void (IComponent::*AudioHook)(AudioEventPacket);
+
+	template <typename Handler, typename Default>
+	static constexpr EntityEventMask Bit(EntityEventType event)
+	{
+		return std::is_same_v<Handler, Default> ? 0 : (EntityEventMask)1 << event;
+	}
+
+	static constexpr EntityEventMask mask =
+		Bit<decltype(&ComponentEventProbe::Update), Hook>(EntityEventType::Update) |
+		Bit<decltype(&ComponentEventProbe::EditingUpdate), Hook>(EntityEventType::EditingUpdate) |
+		Bit<decltype(&ComponentEventProbe::OnEnable), Hook>(EntityEventType::OnEnable) |
+		Bit<decltype(&ComponentEventProbe::OnDisable), Hook>(EntityEventType::OnDisable) |
+		Bit<decltype(&ComponentEventProbe::OnTransform), Hook>(EntityEventType::OnTransform) |
+		Bit<decltype(&ComponentEventProbe::OnMove), VectorHook>(EntityEventType::OnMove) |
+		Bit<decltype(&ComponentEventProbe::OnRotate), VectorHook>(EntityEventType::OnRotate) |
+		Bit<decltype(&ComponentEventProbe::OnScale), VectorHook>(EntityEventType::OnScale) |
+		Bit<decltype(&ComponentEventProbe::OnParentTransform), EntityHook>(EntityEventType::OnParentTransform) |
+		Bit<decltype(&ComponentEventProbe::OnParentMove), EntityHook>(EntityEventType::OnParentMove) |
+		Bit<decltype(&ComponentEventProbe::OnParentRotate), EntityHook>(EntityEventType::OnParentRotate) |
+		Bit<decltype(&ComponentEventProbe::OnParentScale), EntityHook>(EntityEventType::OnParentScale) |
+		Bit<decltype(&ComponentEventProbe::OnCollisionEnter), EntityHook>(EntityEventType::OnCollisionEnter) |
+		Bit<decltype(&ComponentEventProbe::OnTriggerEnter), EntityHook>(EntityEventType::OnTriggerEnter) |
+		Bit<decltype(&ComponentEventProbe::InCollision), EntityHook>(EntityEventType::InCollision) |
+		Bit<decltype(&ComponentEventProbe::InTrigger), EntityHook>(EntityEventType::InTrigger) |
+		Bit<decltype(&ComponentEventProbe::OnCollisionExit), EntityHook>(EntityEventType::OnCollisionExit) |
+		Bit<decltype(&ComponentEventProbe::OnTriggerExit), EntityHook>(EntityEventType::OnTriggerExit) |
+		Bit<decltype(&ComponentEventProbe::OnAudioLoad), AudioHook>(EntityEventType::OnAudioLoad) |
+		Bit<decltype(&ComponentEventProbe::OnAudioPlay), AudioHook>(EntityEventType::OnAudioPlay) |
+		Bit<decltype(&ComponentEventProbe::OnAudioPause), AudioHook>(EntityEventType::OnAudioPause) |
+		Bit<decltype(&ComponentEventProbe::OnAudioEnd), AudioHook>(EntityEventType::OnAudioEnd);
+};
+
+/// <summary>
+/// Which events a component type actually handles, known at compile time.
+/// GameEntity only calls ReceiveEvent on components whose mask has the event's bit.
+/// </summary>
+template <typename T>
+struct ComponentEventTraits
+{
+	static constexpr EntityEventMask mask = ComponentEventProbe<T>::mask;
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+// The low bits of a handle address a slot in a pool, the high bits
+// record which "life" of that slot the handle was issued for
+constexpr uint32_t COMPONENT_HANDLE_INDEX_BITS = 20;
+constexpr uint32_t COMPONENT_HANDLE_INDEX_MASK = (1u << COMPONENT_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t COMPONENT_HANDLE_GENERATION_MASK = (1u << (32 - COMPONENT_HANDLE_INDEX_BITS)) - 1;
+constexpr uint32_t COMPONENT_HANDLE_MAX_SLOTS = COMPONENT_HANDLE_INDEX_MASK;
+
+/// <summary>
+/// A 32-bit reference to a component slot inside its pool.
+/// Freeing a component bumps the generation of its slot, so old
+/// handles to it stop resolving instead of pointing at the next owner.
+/// </summary>
+struct ComponentHandle
+{
+	uint32_t value = UINT32_MAX;
+
+	static ComponentHandle Make(uint32_t index, uint32_t generation) {
+		return ComponentHandle{ (index & COMPONENT_HANDLE_INDEX_MASK) | ((generation & COMPONENT_HANDLE_GENERATION_MASK) << COMPONENT_HANDLE_INDEX_BITS) };
+	}
+
+	uint32_t GetIndex() const { return value & COMPONENT_HANDLE_INDEX_MASK; }
+	uint32_t GetGeneration() const { return value >> COMPONENT_HANDLE_INDEX_BITS; }
+	bool IsValid() const { return value != UINT32_MAX; }
+
+	friend bool operator==(const ComponentHandle& lhs, const ComponentHandle& rhs) { return lhs.value == rhs.value; }
+	friend bool operator!=(const ComponentHandle& lhs, const ComponentHandle& rhs) { return lhs.value != rhs.value; }
+};
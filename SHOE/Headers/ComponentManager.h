@@ -1,12 +1,25 @@
 #pragma once
 #include "ComponentPool.h"
 
+// Filters for ComponentManager::Query, combine with |
+enum ComponentQueryFilter {
+	QUERY_ALL = 0,
+	// Only rows where every queried component is enabled
+	QUERY_ENABLED = 1 << 0,
+	// Only rows whose entity's world transform changed this frame
+	QUERY_CHANGED_THIS_FRAME = 1 << 1
+};
+
+template <typename First, typename... Rest> class ComponentQuery;
+
 class ComponentManager
 {
 public:
 	template <typename T>
 	static std::shared_ptr<T> Instantiate(std::shared_ptr<GameEntity> gameEntity);
 	template <typename T>
+	static std::vector<std::shared_ptr<T>> InstantiateMany(const std::vector<std::shared_ptr<GameEntity>>& gameEntities);
+	template <typename T>
 	static void Free(std::shared_ptr<IComponent> component);
 	template <typename T>
 	static int ActiveCount();
@@ -15,7 +28,29 @@ public:
 	template <typename T>
 	static std::vector<std::shared_ptr<T>> GetAllEnabled();
 	template <typename T>
+	static ComponentView<T> View();
+	template <typename T>
+	static ComponentView<T> ViewEnabled();
+	template <typename T>
+	static ComponentView<T> ViewEnabled(const std::vector<uint32_t>* order);
+	template <typename T>
+	static T* Get(ComponentHandle handle);
+	template <typename T>
+	static std::shared_ptr<T> GetShared(ComponentHandle handle);
+	template <typename T>
+	static bool IsValid(ComponentHandle handle);
+	template <typename T>
+	static void Reserve(uint32_t count);
+	template <typename T>
+	static ComponentStoragePolicy GetPolicy();
+	template <typename T>
+	static void SetPolicy(ComponentStoragePolicy policy);
+	template <typename T>
 	static void Sort();
+
+	// Defined in ComponentQuery.h, include it to use
+	template <typename First, typename... Rest>
+	static ComponentQuery<First, Rest...> Query(unsigned int filters = QUERY_ALL);
 };
 
 /**
@@ -31,6 +66,18 @@ std::shared_ptr<T> ComponentManager::Instantiate(std::shared_ptr<GameEntity> gam
 	return ComponentPool<T>::Instantiate(gameEntity);
 }
 
+/**
+ * \brief Grabs one component per entity from the relevant pool in a single batch
+ * \tparam T The type of component to grab
+ * \param gameEntities The entities to attach to, one component each
+ * \return The new components, in the same order as gameEntities
+ */
+template<typename T>
+std::vector<std::shared_ptr<T>> ComponentManager::InstantiateMany(const std::vector<std::shared_ptr<GameEntity>>& gameEntities)
+{
+	return ComponentPool<T>::InstantiateMany(gameEntities);
+}
+
 /**
  * \brief Frees a component to be reused later
  * \tparam T Type of component to free
@@ -75,6 +122,107 @@ std::vector<std::shared_ptr<T>> ComponentManager::GetAllEnabled()
 	return ComponentPool<T>::GetAllEnabled();
 }
 
+/**
+ * \brief Iterates all in use components from a pool without copying them
+ * \tparam T Type of pool to iterate
+ * \return A view yielding references to each in use component
+ */
+template<typename T>
+ComponentView<T> ComponentManager::View()
+{
+	return ComponentPool<T>::View();
+}
+
+/**
+ * \brief Iterates all enabled components from a pool without copying them.
+ * Disabled components are skipped using the pool's enabled bitset.
+ * \tparam T Type of pool to iterate
+ * \return A view yielding references to each in use and enabled component
+ */
+template<typename T>
+ComponentView<T> ComponentManager::ViewEnabled()
+{
+	return ComponentPool<T>::ViewEnabled();
+}
+
+/**
+ * \brief Iterates enabled components from a pool in a custom order, such as a sorted draw list
+ * \tparam T Type of pool to iterate
+ * \param order Slot indices of components in the pool, must outlive the view
+ * \return A view yielding references to each enabled component in the given order
+ */
+template<typename T>
+ComponentView<T> ComponentManager::ViewEnabled(const std::vector<uint32_t>* order)
+{
+	return ComponentPool<T>::ViewEnabled(order);
+}
+
+/**
+ * \brief Resolves a component handle without copying a shared_ptr
+ * \tparam T Type of pool the handle came from
+ * \param handle The handle to resolve
+ * \return The component, or nullptr if the handle is stale
+ */
+template<typename T>
+T* ComponentManager::Get(ComponentHandle handle)
+{
+	return ComponentPool<T>::Get(handle);
+}
+
+/**
+ * \brief Resolves a component handle to a shared reference
+ * \tparam T Type of pool the handle came from
+ * \param handle The handle to resolve
+ * \return The component, or nullptr if the handle is stale
+ */
+template<typename T>
+std::shared_ptr<T> ComponentManager::GetShared(ComponentHandle handle)
+{
+	return ComponentPool<T>::GetShared(handle);
+}
+
+/**
+ * \brief Whether a component handle still refers to a bound component
+ * \tparam T Type of pool the handle came from
+ */
+template<typename T>
+bool ComponentManager::IsValid(ComponentHandle handle)
+{
+	return ComponentPool<T>::IsValid(handle);
+}
+
+/**
+ * \brief Makes room for count more components of a type in one contiguous block
+ * \tparam T Type of pool to reserve in
+ * \param count How many more components are about to be instantiated
+ */
+template<typename T>
+void ComponentManager::Reserve(uint32_t count)
+{
+	ComponentPool<T>::Reserve(count);
+}
+
+/**
+ * \brief The capacity policy a pool currently grows by
+ * \tparam T Type of pool
+ */
+template<typename T>
+ComponentStoragePolicy ComponentManager::GetPolicy()
+{
+	return ComponentPool<T>::GetPolicy();
+}
+
+/**
+ * \brief Sets a pool's initial size, growth factor, and maximum size with overflow callback
+ * \tparam T Type of pool
+ * \param policy How the pool should grow from now on
+ */
+template<typename T>
+void ComponentManager::SetPolicy(ComponentStoragePolicy policy)
+{
+	ComponentPool<T>::SetPolicy(policy);
+}
+
 /// <summary>
 /// Sorts the component pool, should a sort exist
 /// </summary>
@@ -1,8 +1,14 @@
 #pragma once
 #include <memory>
-#include <queue>
+#include <vector>
+#include <algorithm>
+#include <typeinfo>
 
 #include "GameEntity.fwd.h"
+#include "ComponentStorage.h"
+#include "ComponentView.h"
+#include "ComponentTicks.h"
+#include "MemoryTracker.h"
 #include "MeshRenderer.h"
 #include "Light.h"
 
@@ -13,25 +19,54 @@ class ComponentPool
 {
 public:
 	static std::shared_ptr<T> Instantiate(std::shared_ptr<GameEntity> gameEntity);
+	static std::vector<std::shared_ptr<T>> InstantiateMany(const std::vector<std::shared_ptr<GameEntity>>& gameEntities);
 	static void Free(std::shared_ptr<IComponent> component);
 	static int GetActiveCount();
 	static std::vector<std::shared_ptr<T>> GetAll();
 	static std::vector<std::shared_ptr<T>> GetAllEnabled();
+	static ComponentView<T> View();
+	static ComponentView<T> ViewEnabled();
+	static ComponentView<T> ViewEnabled(const std::vector<uint32_t>* order);
+	static T* Get(ComponentHandle handle);
+	static std::shared_ptr<T> GetShared(ComponentHandle handle);
+	static bool IsValid(ComponentHandle handle);
+	static void Reserve(uint32_t count);
+	static ComponentStoragePolicy GetPolicy();
+	static void SetPolicy(ComponentStoragePolicy policy);
 	static void Sort() {};
 
 private:
-	static std::vector<std::shared_ptr<T>> allocated;
-	static std::queue<std::shared_ptr<T>> unallocated;
+	static void SortIfPending();
+	static void RebuildPositions();
+	static void TrackMemory();
+
+	// Slot indices of bound components, in pool order
+	static std::vector<uint32_t> allocated;
+	// Where each bound slot sits in allocated, so Free can swap and pop
+	static std::vector<uint32_t> positions;
+	static ComponentStorage<T> storage;
+	static ComponentBitset enabled;
+	// Set when components are bound or freed, so pools with an order sort
+	// once before they're next iterated rather than on every change
+	static bool sortPending;
 };
 
-template <> void ComponentPool<MeshRenderer>::Sort();
-template <> void ComponentPool<Light>::Sort();
+template <> inline void ComponentPool<Light>::Sort();
+
+template<typename T>
+std::vector<uint32_t> ComponentPool<T>::allocated = std::vector<uint32_t>();
+
+template<typename T>
+std::vector<uint32_t> ComponentPool<T>::positions = std::vector<uint32_t>();
+
+template<typename T>
+ComponentStorage<T> ComponentPool<T>::storage(ComponentStoragePolicy{ POOL_SIZE });
 
 template<typename T>
-std::vector<std::shared_ptr<T>> ComponentPool<T>::allocated = std::vector<std::shared_ptr<T>>();
+ComponentBitset ComponentPool<T>::enabled = ComponentBitset();
 
 template<typename T>
-std::queue<std::shared_ptr<T>> ComponentPool<T>::unallocated = std::queue<std::shared_ptr<T>>();
+bool ComponentPool<T>::sortPending = false;
 
 /**
  * \brief Binds an unallocated component from the pool to a GameEntity
@@ -42,31 +77,84 @@ std::queue<std::shared_ptr<T>> ComponentPool<T>::unallocated = std::queue<std::s
 template<typename T>
 std::shared_ptr<T> ComponentPool<T>::Instantiate(std::shared_ptr<GameEntity> gameEntity)
 {
-	//Allocates a new pool if there is no available components
-	if (unallocated.size() == 0) {
-		for (int i = 0; i < POOL_SIZE; i++) {
-			unallocated.push(std::make_shared<T>());
-		}
-	}
+	TrackMemory();
 
-	std::shared_ptr<T> component = unallocated.front();
-	allocated.emplace_back(component);
-	unallocated.pop();
+	//The storage grows by its policy if no components are available
+	ComponentHandle handle = storage.Allocate();
+	std::shared_ptr<T> component = storage.GetShared(handle);
+	component->handle = handle;
+	component->enabledSet = &enabled;
+	if (positions.size() < storage.GetCapacity()) positions.resize(storage.GetCapacity());
+	positions[handle.GetIndex()] = (uint32_t)allocated.size();
+	allocated.emplace_back(handle.GetIndex());
 	component->Bind(gameEntity);
-	Sort();
+	component->RefreshEnabledState();
+	ComponentTicks::Register<T>();
+	sortPending = true;
 	return component;
 }
 
 /**
- * \brief Unbinds a given component and marks it free for use
+ * \brief Binds one component to each of many GameEntities.
+ * Slots are reserved up front, and every component is bound before any Start runs.
+ * \param gameEntities The GameEntities to attach to, one component each
+ * \return The new components, in the same order as gameEntities
+ */
+template<typename T>
+std::vector<std::shared_ptr<T>> ComponentPool<T>::InstantiateMany(const std::vector<std::shared_ptr<GameEntity>>& gameEntities)
+{
+	std::vector<std::shared_ptr<T>> components = std::vector<std::shared_ptr<T>>();
+	components.reserve(gameEntities.size());
+	Reserve((uint32_t)gameEntities.size());
+	positions.resize(storage.GetCapacity());
+
+	for (const std::shared_ptr<GameEntity>& gameEntity : gameEntities) {
+		ComponentHandle handle = storage.Allocate();
+		std::shared_ptr<T> component = storage.GetShared(handle);
+		component->handle = handle;
+		component->enabledSet = &enabled;
+		positions[handle.GetIndex()] = (uint32_t)allocated.size();
+		allocated.emplace_back(handle.GetIndex());
+		component->Bind(gameEntity, false);
+		components.push_back(component);
+	}
+
+	for (std::shared_ptr<T>& component : components) {
+		static_cast<IComponent*>(component.get())->Start();
+		component->RefreshEnabledState();
+	}
+
+	ComponentTicks::Register<T>();
+	sortPending = true;
+	return components;
+}
+
+/**
+ * \brief Unbinds a given component and marks it free for use.
+ * The last component in pool order takes its place, so this is O(1)
+ * but doesn't preserve order; pools that need an order re-sort before
+ * they're next iterated.
  * \param component The component to unbind
  */
 template<typename T>
 void ComponentPool<T>::Free(std::shared_ptr<IComponent> component)
 {
+	// Already freed, nothing to unbind
+	if (!storage.IsValid(component->handle)) return;
+
 	component->Free();
-	unallocated.push(std::dynamic_pointer_cast<T>(component));
-	allocated.erase(std::remove(allocated.begin(), allocated.end(), std::dynamic_pointer_cast<T>(component)), allocated.end());
+	uint32_t index = component->handle.GetIndex();
+	enabled.Set(index, false);
+	storage.Release(component->handle);
+	component->handle = ComponentHandle();
+	component->enabledSet = nullptr;
+
+	uint32_t position = positions[index];
+	uint32_t last = allocated.back();
+	allocated[position] = last;
+	positions[last] = position;
+	allocated.pop_back();
+	sortPending = true;
 }
 
 /**
@@ -85,7 +173,14 @@ int ComponentPool<T>::GetActiveCount()
 template<typename T>
 std::vector<std::shared_ptr<T>> ComponentPool<T>::GetAll()
 {
-	return allocated;
+	SortIfPending();
+	std::vector<std::shared_ptr<T>> all = std::vector<std::shared_ptr<T>>();
+	all.reserve(allocated.size());
+	for (uint32_t index : allocated)
+	{
+		all.emplace_back(storage.GetSharedAt(index));
+	}
+	return all;
 }
 
 /**
@@ -94,29 +189,149 @@ std::vector<std::shared_ptr<T>> ComponentPool<T>::GetAll()
 template<typename T>
 std::vector<std::shared_ptr<T>> ComponentPool<T>::GetAllEnabled()
 {
-	std::vector<std::shared_ptr<T>> enabled = std::vector<std::shared_ptr<T>>();
-	for(std::shared_ptr<T> component : allocated)
+	SortIfPending();
+	std::vector<std::shared_ptr<T>> enabledComponents = std::vector<std::shared_ptr<T>>();
+	for (uint32_t index : allocated)
 	{
-		if(component->IsEnabled())
+		if (enabled.Test(index))
 		{
-			enabled.emplace_back(component);
+			enabledComponents.emplace_back(storage.GetSharedAt(index));
 		}
 	}
-	return enabled;
+	return enabledComponents;
 }
 
-template <> void ComponentPool<MeshRenderer>::Sort()
+/**
+ * \brief Iterates all currently bound components in place, without copying
+ */
+template<typename T>
+ComponentView<T> ComponentPool<T>::View()
 {
-	std::sort(allocated.begin(), allocated.end(), [](std::shared_ptr<MeshRenderer> a, std::shared_ptr<MeshRenderer> b) {
-		if (a->GetMaterial()->GetTransparent() != b->GetMaterial()->GetTransparent())
-			return b->GetMaterial()->GetTransparent();
-		return a->GetMaterial() < b->GetMaterial();
-		});
+	SortIfPending();
+	return ComponentView<T>(&storage, &allocated);
+}
+
+/**
+ * \brief Iterates all currently bound and enabled components in place, without copying
+ */
+template<typename T>
+ComponentView<T> ComponentPool<T>::ViewEnabled()
+{
+	SortIfPending();
+	return ComponentView<T>(&storage, &allocated, &enabled);
+}
+
+/**
+ * \brief Iterates enabled components in a caller supplied order of slot indices
+ * \param order Slot indices of components in this pool, must outlive the view
+ */
+template<typename T>
+ComponentView<T> ComponentPool<T>::ViewEnabled(const std::vector<uint32_t>* order)
+{
+	return ComponentView<T>(&storage, order, &enabled);
+}
+
+/**
+ * \brief Resolves a handle to a component in this pool without touching reference counts
+ * \param handle Handle returned from GetHandle() on a component of this type
+ * \return The component, or nullptr if it has since been freed
+ */
+template<typename T>
+T* ComponentPool<T>::Get(ComponentHandle handle)
+{
+	return storage.Get(handle);
+}
+
+/**
+ * \brief Resolves a handle to a shared reference to a component in this pool
+ * \param handle Handle returned from GetHandle() on a component of this type
+ * \return The component, or nullptr if it has since been freed
+ */
+template<typename T>
+std::shared_ptr<T> ComponentPool<T>::GetShared(ComponentHandle handle)
+{
+	return storage.GetShared(handle);
+}
+
+/**
+ * \brief Whether a handle still refers to a bound component in this pool
+ */
+template<typename T>
+bool ComponentPool<T>::IsValid(ComponentHandle handle)
+{
+	return storage.IsValid(handle);
+}
+
+/**
+ * \brief Makes room for count more components in one contiguous block,
+ * so instantiating them won't grow the pool piecemeal
+ * \param count How many more components are about to be instantiated
+ */
+template<typename T>
+void ComponentPool<T>::Reserve(uint32_t count)
+{
+	TrackMemory();
+	storage.Reserve(count);
+	allocated.reserve(allocated.size() + count);
+}
+
+template<typename T>
+ComponentStoragePolicy ComponentPool<T>::GetPolicy()
+{
+	return storage.GetPolicy();
+}
+
+/**
+ * \brief Sets how this pool grows from now on, ideally before anything is instantiated
+ * \param policy Initial size, growth factor, and maximum size with overflow callback
+ */
+template<typename T>
+void ComponentPool<T>::SetPolicy(ComponentStoragePolicy policy)
+{
+	storage.SetPolicy(policy);
+}
+
+/**
+ * \brief Runs Sort if anything was bound or freed since it last ran
+ */
+template<typename T>
+void ComponentPool<T>::SortIfPending()
+{
+	if (!sortPending) return;
+	sortPending = false;
+	Sort();
+}
+
+/**
+ * \brief Recomputes every bound slot's position after allocated is reordered
+ */
+template<typename T>
+void ComponentPool<T>::RebuildPositions()
+{
+	for (uint32_t i = 0; i < allocated.size(); i++) {
+		positions[allocated[i]] = i;
+	}
+}
+
+/**
+ * \brief Adds this pool to the MemoryTracker's slot counts the first time it's used
+ */
+template<typename T>
+void ComponentPool<T>::TrackMemory()
+{
+	static bool tracked = false;
+	if (tracked) return;
+	tracked = true;
+
+	MemoryTracker::RegisterPool(typeid(T).name(), sizeof(T),
+		[]() { return storage.GetCapacity(); },
+		[]() { return storage.GetFreeCount(); });
 }
 
-template <> void ComponentPool<Light>::Sort()
+template <> inline void ComponentPool<Light>::Sort()
 {
-	std::sort(allocated.begin(), allocated.end(), [](std::shared_ptr<Light> a, std::shared_ptr<Light> b) {
-		return a->GetType() > b->GetType();
+	std::sort(allocated.begin(), allocated.end(), [](uint32_t a, uint32_t b) {
+		return storage.GetAt(a)->GetType() > storage.GetAt(b)->GetType();
 		});
+	RebuildPositions();
 }
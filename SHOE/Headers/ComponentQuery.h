@@ -0,0 +1,115 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+
+#include "GameEntity.h"
+#include "ComponentTypeID.h"
+
+/// <summary>
+/// A join over the component pools: every entity that has all of the queried
+/// component types, yielded as a tuple of references.
+/// The first type's pool drives iteration and the rest are found through each
+/// entity's component table, so a row costs a mask test plus one index per type.
+/// If an entity has several components of a later type, the first is used.
+/// </summary>
+template <typename First, typename... Rest>
+class ComponentQuery
+{
+	static_assert((RegisteredComponent<First> && ... && RegisteredComponent<Rest>), "Queried component types need a ComponentType registration");
+
+public:
+	typedef std::tuple<First&, Rest&...> Row;
+
+	class Iterator
+	{
+	public:
+		Iterator(const ComponentQuery* query, size_t position)
+			: query(query), position(position) {
+			SkipUnmatched();
+		}
+
+		Row operator*() const { return query->MakeRow(position); }
+
+		Iterator& operator++() {
+			position++;
+			SkipUnmatched();
+			return *this;
+		}
+
+		bool operator!=(const Iterator& other) const { return position < query->view.size() && position != other.position; }
+		bool operator==(const Iterator& other) const { return !(*this != other); }
+
+	private:
+		void SkipUnmatched() {
+			while (position < query->view.size() && !query->Matches(position)) {
+				position++;
+			}
+		}
+
+		const ComponentQuery* query;
+		size_t position;
+	};
+
+	ComponentQuery(ComponentView<First> view, unsigned int filters)
+		: view(view), filters(filters) {}
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, view.size()); }
+
+	/// <summary>
+	/// Number of rows that currently match
+	/// </summary>
+	size_t Count() const {
+		size_t count = 0;
+		for (size_t i = 0; i < view.size(); i++) {
+			if (Matches(i)) count++;
+		}
+		return count;
+	}
+
+private:
+	static constexpr ComponentMask requiredMask = (GetComponentTypeMask<First>() | ... | GetComponentTypeMask<Rest>());
+
+	template <typename T>
+	static T& Fetch(GameEntity* entity) {
+		if constexpr (std::is_same_v<T, Transform>) return *entity->transform;
+		else return static_cast<T&>(*entity->componentList[entity->firstComponentOfType[GetComponentTypeID<T>()]]);
+	}
+
+	bool Matches(size_t position) const {
+		if (!view.Includes(position)) return false;
+
+		GameEntity* entity = view[position].gameEntity.get();
+		if (entity == nullptr || (entity->componentMask & requiredMask) != requiredMask) return false;
+
+		// The first component's enabled state is already covered by the view's filter
+		if ((filters & QUERY_ENABLED) && !(Fetch<Rest>(entity).IsLocallyEnabled() && ...)) return false;
+		if ((filters & QUERY_CHANGED_THIS_FRAME) && !entity->transform->ChangedThisFrame()) return false;
+
+		return true;
+	}
+
+	Row MakeRow(size_t position) const {
+		First& first = view[position];
+		GameEntity* entity = first.gameEntity.get();
+		return Row(first, Fetch<Rest>(entity)...);
+	}
+
+	ComponentView<First> view;
+	unsigned int filters;
+};
+
+/**
+ * \brief Iterates every entity that has all of the given component types
+ * \tparam First Type whose pool drives the iteration, ideally the rarest one
+ * \tparam Rest Other types each entity must also have
+ * \param filters ComponentQueryFilter flags to narrow the rows
+ * \return An iterable of tuples of references, one per matching entity
+ */
+template <typename First, typename... Rest>
+ComponentQuery<First, Rest...> ComponentManager::Query(unsigned int filters)
+{
+	return ComponentQuery<First, Rest...>(
+		(filters & QUERY_ENABLED) ? ComponentPool<First>::ViewEnabled() : ComponentPool<First>::View(),
+		filters);
+}
@@ -0,0 +1,296 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+
+#include "ComponentHandle.h"
+#include "MemoryTracker.h"
+
+// Chunks start on a cache line so the first components of each chunk
+// never straddle a line shared with unrelated heap data
+constexpr size_t COMPONENT_CHUNK_ALIGNMENT = 64;
+
+/// <summary>
+/// How a ComponentStorage sizes its chunks
+/// </summary>
+struct ComponentStoragePolicy
+{
+	// Slots in the first chunk, and the smallest chunk grown on demand
+	uint32_t initialSize = 32;
+	// Total capacity is multiplied by this whenever the storage grows on demand.
+	// 1 grows in fixed steps of initialSize.
+	float growthFactor = 2.0f;
+	// Hard cap on total slots, never more than COMPONENT_HANDLE_MAX_SLOTS
+	uint32_t maxSize = COMPONENT_HANDLE_MAX_SLOTS;
+	// Called with the capacity that was asked for when growing would pass maxSize.
+	// Whatever still fits is allocated, and if no slot is free after the callback
+	// the allocation throws std::length_error, so it may free components to make room.
+	std::function<void(uint32_t requested)> onOverflow;
+};
+
+/// <summary>
+/// Dense backing store for one component type.
+/// Components live in contiguous, cache-line-aligned chunks instead of one heap
+/// block each, and are addressed by generational ComponentHandles. Each slot also
+/// keeps a non-owning shared_ptr so the existing shared_ptr API keeps working.
+/// </summary>
+template <typename T>
+class ComponentStorage
+{
+public:
+	ComponentStorage(ComponentStoragePolicy policy = ComponentStoragePolicy());
+	~ComponentStorage();
+
+	ComponentStorage(ComponentStorage const&) = delete;
+	void operator=(ComponentStorage const&) = delete;
+
+	ComponentHandle Allocate();
+	void Release(ComponentHandle handle);
+	void Reserve(uint32_t count);
+
+	ComponentStoragePolicy GetPolicy();
+	void SetPolicy(ComponentStoragePolicy policy);
+
+	bool IsValid(ComponentHandle handle);
+	T* Get(ComponentHandle handle);
+	std::shared_ptr<T> GetShared(ComponentHandle handle);
+
+	T* GetAt(uint32_t index);
+	std::shared_ptr<T> GetSharedAt(uint32_t index);
+
+	uint32_t GetCapacity();
+	uint32_t GetFreeCount();
+	uint32_t GetChunkCount();
+
+private:
+	struct Chunk
+	{
+		T* components;
+		uint32_t size;
+	};
+
+	void Grow(uint32_t count);
+	void AllocateChunk(uint32_t size);
+
+	ComponentStoragePolicy policy;
+	std::vector<Chunk> chunks;
+
+	// Per-slot data, indexed by the handle index
+	std::vector<T*> slots;
+	std::vector<uint32_t> generations;
+	std::vector<bool> live;
+	std::vector<std::shared_ptr<T>> sharedSlots;
+
+	// Stack of free slot indices, lowest index on top
+	std::vector<uint32_t> freeSlots;
+};
+
+template<typename T>
+ComponentStorage<T>::ComponentStorage(ComponentStoragePolicy policy)
+{
+	SetPolicy(policy);
+}
+
+template<typename T>
+ComponentStorage<T>::~ComponentStorage()
+{
+	// Anything still holding a shared_ptr from here only holds the control
+	// block, the deleter is a no-op, so the storage is the sole owner
+	sharedSlots.clear();
+	for (Chunk& chunk : chunks) {
+		for (uint32_t i = 0; i < chunk.size; i++) {
+			chunk.components[i].~T();
+		}
+		::operator delete(chunk.components, std::align_val_t(COMPONENT_CHUNK_ALIGNMENT));
+	}
+	chunks.clear();
+	slots.clear();
+}
+
+/// <summary>
+/// Adds a chunk of up to count slots, clamped to the policy's maxSize
+/// </summary>
+template<typename T>
+void ComponentStorage<T>::Grow(uint32_t count)
+{
+	uint32_t capacity = GetCapacity();
+	uint32_t maxSize = std::min<uint32_t>(policy.maxSize, COMPONENT_HANDLE_MAX_SLOTS);
+	if (capacity + count > maxSize) {
+		if (policy.onOverflow) policy.onOverflow(capacity + count);
+		count = maxSize > capacity ? maxSize - capacity : 0;
+	}
+
+	if (count > 0) AllocateChunk(count);
+}
+
+/// <summary>
+/// Constructs a new chunk of components in place and marks all of its slots free
+/// </summary>
+template<typename T>
+void ComponentStorage<T>::AllocateChunk(uint32_t size)
+{
+	MemoryScope memoryScope(MEMORY_COMPONENT_POOLS);
+	uint32_t firstIndex = GetCapacity();
+
+	static_assert(alignof(T) <= COMPONENT_CHUNK_ALIGNMENT, "Component types must not be over-aligned past a cache line");
+
+	T* chunk = static_cast<T*>(::operator new(sizeof(T) * size, std::align_val_t(COMPONENT_CHUNK_ALIGNMENT)));
+	for (uint32_t i = 0; i < size; i++) {
+		new (&chunk[i]) T();
+	}
+	chunks.push_back({ chunk, size });
+
+	// No exact reserves here, they'd defeat geometric growth when chunks are small
+	generations.resize(firstIndex + size, 0);
+	live.resize(firstIndex + size, false);
+	for (uint32_t i = 0; i < size; i++) {
+		slots.push_back(&chunk[i]);
+		// Non-owning, the chunk owns the object. Also seeds enable_shared_from_this
+		sharedSlots.emplace_back(&chunk[i], [](T*) {});
+	}
+
+	// Pushed in reverse so the lowest, most recently touched indices are reused first
+	for (uint32_t i = firstIndex + size; i > firstIndex; i--) {
+		freeSlots.push_back(i - 1);
+	}
+}
+
+/// <summary>
+/// Claims a free slot, growing by the policy if none are left
+/// </summary>
+/// <returns>A handle to the claimed slot</returns>
+template<typename T>
+ComponentHandle ComponentStorage<T>::Allocate()
+{
+	if (freeSlots.empty()) {
+		uint32_t capacity = GetCapacity();
+		uint32_t growth = (uint32_t)(capacity * (policy.growthFactor - 1.0f));
+		Grow(std::max<uint32_t>(policy.initialSize, growth));
+
+		// Only possible at maxSize, if the overflow callback didn't free anything
+		if (freeSlots.empty()) {
+			throw std::length_error("Component pool reached its maximum size");
+		}
+	}
+
+	uint32_t index = freeSlots.back();
+	freeSlots.pop_back();
+	live[index] = true;
+	return ComponentHandle::Make(index, generations[index]);
+}
+
+/// <summary>
+/// Returns a slot to the free list and invalidates all handles to it.
+/// The object itself is kept constructed for reuse.
+/// </summary>
+template<typename T>
+void ComponentStorage<T>::Release(ComponentHandle handle)
+{
+	if (!IsValid(handle)) return;
+
+	uint32_t index = handle.GetIndex();
+	live[index] = false;
+	generations[index] = (generations[index] + 1) & COMPONENT_HANDLE_GENERATION_MASK;
+	freeSlots.push_back(index);
+}
+
+/// <summary>
+/// Makes sure at least count more slots can be allocated without growing,
+/// adding whatever is missing as one contiguous chunk
+/// </summary>
+template<typename T>
+void ComponentStorage<T>::Reserve(uint32_t count)
+{
+	if (GetFreeCount() < count) {
+		Grow(count - GetFreeCount());
+	}
+}
+
+template<typename T>
+ComponentStoragePolicy ComponentStorage<T>::GetPolicy()
+{
+	return policy;
+}
+
+/// <summary>
+/// Changes how the storage grows from now on. Existing chunks are kept.
+/// </summary>
+template<typename T>
+void ComponentStorage<T>::SetPolicy(ComponentStoragePolicy policy)
+{
+	this->policy = policy;
+	if (this->policy.initialSize == 0) this->policy.initialSize = 1;
+	if (this->policy.growthFactor < 1.0f) this->policy.growthFactor = 1.0f;
+}
+
+/// <summary>
+/// Whether a handle still refers to the component it was issued for
+/// </summary>
+template<typename T>
+bool ComponentStorage<T>::IsValid(ComponentHandle handle)
+{
+	uint32_t index = handle.GetIndex();
+	return handle.IsValid() && index < generations.size() && live[index] && generations[index] == handle.GetGeneration();
+}
+
+/// <summary>
+/// Resolves a handle without touching any reference counts
+/// </summary>
+/// <returns>The component, or nullptr if the handle is stale</returns>
+template<typename T>
+T* ComponentStorage<T>::Get(ComponentHandle handle)
+{
+	if (!IsValid(handle)) return nullptr;
+	return GetAt(handle.GetIndex());
+}
+
+/// <summary>
+/// Resolves a handle into the shared_ptr form used by the rest of the engine
+/// </summary>
+/// <returns>The component, or nullptr if the handle is stale</returns>
+template<typename T>
+std::shared_ptr<T> ComponentStorage<T>::GetShared(ComponentHandle handle)
+{
+	if (!IsValid(handle)) return nullptr;
+	return sharedSlots[handle.GetIndex()];
+}
+
+/// <summary>
+/// Raw slot access for pool internals that already know the slot is live
+/// </summary>
+template<typename T>
+T* ComponentStorage<T>::GetAt(uint32_t index)
+{
+	return slots[index];
+}
+
+template<typename T>
+std::shared_ptr<T> ComponentStorage<T>::GetSharedAt(uint32_t index)
+{
+	return sharedSlots[index];
+}
+
+/// <summary>
+/// Total slots constructed across all chunks
+/// </summary>
+template<typename T>
+uint32_t ComponentStorage<T>::GetCapacity()
+{
+	return (uint32_t)slots.size();
+}
+
+template<typename T>
+uint32_t ComponentStorage<T>::GetFreeCount()
+{
+	return (uint32_t)freeSlots.size();
+}
+
+template<typename T>
+uint32_t ComponentStorage<T>::GetChunkCount()
+{
+	return (uint32_t)chunks.size();
+}
+
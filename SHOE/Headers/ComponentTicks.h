@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "IComponent.h"
+#include "ComponentTypeID.h"
+
+template <typename T> class ComponentPool;
+
+/// <summary>
+/// Derives from a component so its protected Update overrides are visible.
+/// &ComponentTickProbe::Update is an IComponent member pointer unless
+/// T, or a class between T and IComponent, declares its own Update.
+/// </summary>
+template <typename T>
+struct ComponentTickProbe : T
+{
+	typedef decltype(&ComponentTickProbe::Update) UpdateType;
+	typedef decltype(&ComponentTickProbe::EditingUpdate) EditingUpdateType;
+};
+
+/// <summary>
+/// Which per-frame hooks a component type overrides, known at compile time
+/// </summary>
+template <typename T>
+struct ComponentTickTraits
+{
+	static constexpr bool hasUpdate = !std::is_same_v<typename ComponentTickProbe<T>::UpdateType, void (IComponent::*)()>;
+	static constexpr bool hasEditingUpdate = !std::is_same_v<typename ComponentTickProbe<T>::EditingUpdateType, void (IComponent::*)()>;
+};
+
+/// <summary>
+/// Per-type lists of the components that actually do something on Update or
+/// EditingUpdate. A type is added the first time its pool instantiates a
+/// component, and only if it overrides one of those hooks, so mostly-static
+/// types like MeshRenderer or Collider cost nothing per frame.
+/// </summary>
+class ComponentTicks
+{
+public:
+	template <typename T>
+	static void Register();
+
+	static void Run(EntityEventType phase);
+
+private:
+	struct TickList
+	{
+		ComponentTypes type;
+		bool update;
+		bool editingUpdate;
+		void (*tick)(EntityEventType phase);
+	};
+
+	// Ordered by ComponentTypes, so types always tick in the same order
+	static std::vector<TickList> tickLists;
+};
+
+/**
+ * \brief Adds T's tick list if T overrides Update or EditingUpdate.
+ * Called by ComponentPool<T>::Instantiate, safe to call repeatedly.
+ * \tparam T Component type
+ */
+template <typename T>
+void ComponentTicks::Register()
+{
+	typedef ComponentTickTraits<T> Traits;
+	if constexpr (Traits::hasUpdate || Traits::hasEditingUpdate) {
+		static bool registered = false;
+		if (registered) return;
+		registered = true;
+
+		TickList list = { GetComponentTypeID<T>(), Traits::hasUpdate, Traits::hasEditingUpdate,
+			[](EntityEventType phase) {
+				// Walks the pool's enabled bitset, so disabled components and entities are skipped for free
+				for (T& component : ComponentPool<T>::ViewEnabled()) {
+					IComponent& base = component;
+					if (phase == EntityEventType::Update) base.Update();
+					else base.EditingUpdate();
+				}
+			} };
+
+		auto position = std::upper_bound(tickLists.begin(), tickLists.end(), list,
+			[](const TickList& a, const TickList& b) { return a.type < b.type; });
+		tickLists.insert(position, list);
+	}
+}
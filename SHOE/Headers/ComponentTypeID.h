@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+
+enum ComponentTypes {
+	// While Transform is tracked here, it is often skipped or handled uniquely
+	// when assessing all components, as it cannot be removed or doubled
+	TRANSFORM,
+	MESH_RENDERER,
+	PARTICLE_SYSTEM,
+	COLLIDER,
+	TERRAIN,
+	LIGHT,
+	CAMERA,
+	NOCLIP_CHAR_CONTROLLER,
+	FLASHLIGHT_CONTROLLER,
+	AUDIO_RESPONSE_DEVICE,
+	// Must always be the final enum
+	COMPONENT_TYPE_COUNT
+};
+
+// One bit per ComponentTypes entry
+typedef uint32_t ComponentMask;
+static_assert(COMPONENT_TYPE_COUNT <= sizeof(ComponentMask) * 8, "ComponentMask is too small for every component type");
+
+class Transform;
+class MeshRenderer;
+class ParticleSystem;
+class Collider;
+class Terrain;
+class Light;
+class Camera;
+class NoclipMovement;
+class FlashlightController;
+class AudioResponse;
+
+/// <summary>
+/// Maps a component class to its ComponentTypes entry at compile time.
+/// Types without a specialization still work on a GameEntity, they just
+/// fall back to a dynamic_pointer_cast search.
+/// </summary>
+template <typename T>
+struct ComponentType {};
+
+#define REGISTER_COMPONENT_TYPE(type, id) \
+	template <> struct ComponentType<type> { static constexpr ComponentTypes ID = id; }
+
+REGISTER_COMPONENT_TYPE(Transform, TRANSFORM);
+REGISTER_COMPONENT_TYPE(MeshRenderer, MESH_RENDERER);
+REGISTER_COMPONENT_TYPE(ParticleSystem, PARTICLE_SYSTEM);
+REGISTER_COMPONENT_TYPE(Collider, COLLIDER);
+REGISTER_COMPONENT_TYPE(Terrain, TERRAIN);
+REGISTER_COMPONENT_TYPE(Light, LIGHT);
+REGISTER_COMPONENT_TYPE(Camera, CAMERA);
+REGISTER_COMPONENT_TYPE(NoclipMovement, NOCLIP_CHAR_CONTROLLER);
+REGISTER_COMPONENT_TYPE(FlashlightController, FLASHLIGHT_CONTROLLER);
+REGISTER_COMPONENT_TYPE(AudioResponse, AUDIO_RESPONSE_DEVICE);
+
+template <typename T>
+concept RegisteredComponent = requires { ComponentType<T>::ID; };
+
+/// <summary>
+/// The ComponentTypes entry for a component class, or COMPONENT_TYPE_COUNT if it has none
+/// </summary>
+template <typename T>
+constexpr ComponentTypes GetComponentTypeID()
+{
+	if constexpr (RegisteredComponent<T>) return ComponentType<T>::ID;
+	else return COMPONENT_TYPE_COUNT;
+}
+
+/// <summary>
+/// The mask bit for a component class, or 0 if it has no ComponentTypes entry
+/// </summary>
+template <typename T>
+constexpr ComponentMask GetComponentTypeMask()
+{
+	if constexpr (RegisteredComponent<T>) return (ComponentMask)1 << ComponentType<T>::ID;
+	else return 0;
+}
+
+// Every bit of a ComponentMask that maps to a component type
+constexpr ComponentMask ALL_COMPONENTS_MASK = (ComponentMask)(((uint64_t)1 << COMPONENT_TYPE_COUNT) - 1);
+
+/// <summary>
+/// A compile-time set of component types, used to declare what a
+/// scheduled system reads or writes
+/// </summary>
+template <typename... T>
+struct ComponentAccess
+{
+	static constexpr ComponentMask mask = (GetComponentTypeMask<T>() | ... | (ComponentMask)0);
+};
+
+// What a system that moves, rotates or scales entities has to declare as written.
+// Setters only send OnMove, OnRotate and OnScale straight away, and Light is the one
+// type handling those. OnTransform and OnParentTransform wait for Transform::NotifyChanges,
+// after every system has run, so their handlers don't count.
+typedef ComponentAccess<Transform, Light> TransformWriteAccess;
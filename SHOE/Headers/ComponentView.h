@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "ComponentStorage.h"
+
+/// <summary>
+/// A growable bitset indexed by component slot.
+/// Pools use it to track which slots are currently enabled so filtered
+/// iteration never has to call into the component itself.
+/// </summary>
+class ComponentBitset
+{
+public:
+	void Set(uint32_t index, bool value) {
+		uint32_t word = index >> 6;
+		if (word >= words.size()) {
+			if (!value) return;
+			words.resize(word + 1, 0);
+		}
+		uint64_t mask = 1ull << (index & 63);
+		if (value) words[word] |= mask;
+		else words[word] &= ~mask;
+	}
+
+	bool Test(uint32_t index) const {
+		uint32_t word = index >> 6;
+		return word < words.size() && (words[word] >> (index & 63)) & 1ull;
+	}
+
+	void Clear() {
+		words.clear();
+	}
+
+private:
+	std::vector<uint64_t> words;
+};
+
+/// <summary>
+/// A non-owning range over the components of a pool, in pool order.
+/// Iterating yields references straight out of the pool's storage, so no
+/// shared_ptrs are copied and nothing is allocated. A view reads the pool
+/// live: components added while iterating are visited, and it should not
+/// be kept across frames.
+/// </summary>
+template <typename T>
+class ComponentView
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator(ComponentStorage<T>* storage, const std::vector<uint32_t>* order, const ComponentBitset* filter, size_t position)
+			: storage(storage), order(order), filter(filter), position(position) {
+			SkipFiltered();
+		}
+
+		T& operator*() const { return *storage->GetAt((*order)[position]); }
+		T* operator->() const { return storage->GetAt((*order)[position]); }
+
+		Iterator& operator++() {
+			position++;
+			SkipFiltered();
+			return *this;
+		}
+
+		// Compared against end() by position only, so appends during iteration are safe
+		bool operator!=(const Iterator& other) const { return position < order->size() && position != other.position; }
+		bool operator==(const Iterator& other) const { return !(*this != other); }
+
+	private:
+		void SkipFiltered() {
+			if (filter == nullptr) return;
+			while (position < order->size() && !filter->Test((*order)[position])) {
+				position++;
+			}
+		}
+
+		ComponentStorage<T>* storage;
+		const std::vector<uint32_t>* order;
+		const ComponentBitset* filter;
+		size_t position;
+	};
+
+	ComponentView(ComponentStorage<T>* storage, const std::vector<uint32_t>* order, const ComponentBitset* filter = nullptr)
+		: storage(storage), order(order), filter(filter) {}
+
+	Iterator begin() const { return Iterator(storage, order, filter, 0); }
+	Iterator end() const { return Iterator(storage, order, nullptr, order->size()); }
+
+	/// <summary>
+	/// Whether this view skips disabled components
+	/// </summary>
+	bool IsFiltered() const { return filter != nullptr; }
+
+	/// <summary>
+	/// Number of components in the underlying pool, ignoring any filter
+	/// </summary>
+	size_t size() const { return order->size(); }
+	bool empty() const { return order->empty(); }
+
+	/// <summary>
+	/// Positional access into the pool order, ignoring any filter
+	/// </summary>
+	T& operator[](size_t position) const { return *storage->GetAt((*order)[position]); }
+
+	/// <summary>
+	/// Whether the component at a position in pool order passes this view's filter
+	/// </summary>
+	bool Includes(size_t position) const { return filter == nullptr || filter->Test((*order)[position]); }
+
+private:
+	ComponentStorage<T>* storage;
+	const std::vector<uint32_t>* order;
+	const ComponentBitset* filter;
+};
@@ -2,6 +2,8 @@
 
 #include "../Headers/Renderer.h"
 
+struct RenderSnapshot;
+
 class DX11Renderer : public Renderer {
 private:
     Microsoft::WRL::ComPtr<ID3D11Device> device;
@@ -25,6 +27,9 @@ private:
     std::shared_ptr<Mesh> cubeMesh;
     std::shared_ptr<Mesh> sphereMesh;
 
+    // The snapshot this frame draws, chosen once at the start of Draw
+    const RenderSnapshot* drawSnapshot;
+
     //components for shadows
     int shadowCount;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shadowDSVArraySRV;
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "EntityEvent.h"
+
+/// <summary>
+/// Lets threads other than the main one, like FMOD's callbacks or asset
+/// loaders, send entity events without touching scene state. Posting is
+/// lock free: a producer claims a slot in a fixed size ring with a single
+/// compare and swap and writes its event there. The main thread drains the
+/// ring once per frame in Flush, grouped by event type.
+/// The instance must be created on the main thread before any producer runs.
+/// </summary>
+class DeferredEventBus
+{
+#pragma region Singleton
+public:
+	// Gets the one and only instance of this class
+	static DeferredEventBus& GetInstance()
+	{
+		if (!instance)
+		{
+			instance = new DeferredEventBus();
+		}
+
+		return *instance;
+	}
+
+	// Remove these functions (C++ 11 version)
+	DeferredEventBus(DeferredEventBus const&) = delete;
+	void operator=(DeferredEventBus const&) = delete;
+
+private:
+	static DeferredEventBus* instance;
+	DeferredEventBus();
+#pragma endregion
+public:
+	~DeferredEventBus();
+
+	// Events that can be waiting at once. Posts past this are dropped.
+	static constexpr size_t Capacity = 4096;
+
+	bool Post(EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
+	bool PostTo(std::weak_ptr<GameEntity> target, EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
+
+	template <EntityEventType Event>
+	bool Post();
+	template <EntityEventType Event, typename Payload>
+	bool Post(const Payload& payload);
+
+	void Flush();
+
+	size_t GetPendingCount();
+	size_t GetDroppedCount();
+	size_t GetLastFlushCount();
+
+private:
+	struct DeferredEvent
+	{
+		EntityEventType event;
+		EntityEventMessage message;
+		// Empty for events sent to every entity
+		std::weak_ptr<GameEntity> target;
+		bool broadcast;
+	};
+
+	struct Slot
+	{
+		// Equal to the slot's position when it's free to write,
+		// and one past it once the event in it is ready to read
+		std::atomic<size_t> sequence;
+		DeferredEvent entry;
+	};
+
+	bool Enqueue(EntityEventType event, const EntityEventMessage& message, std::weak_ptr<GameEntity> target, bool broadcast);
+
+	std::unique_ptr<Slot[]> slots;
+
+	// Kept on separate cache lines, as every producer writes the first
+	// and only the main thread touches the second
+	alignas(64) std::atomic<size_t> enqueuePosition;
+	alignas(64) size_t dequeuePosition;
+
+	std::atomic<size_t> droppedCount;
+	size_t lastFlushCount;
+
+	// Reused every Flush, one list per event type, so draining doesn't allocate once warmed up
+	std::vector<DeferredEvent> batches[EventCount];
+	std::vector<EntityEventMessage> broadcastBatch;
+};
+
+/**
+ * \brief Posts an event that carries no message to every entity, checked at compile time
+ * \tparam Event Message type to send
+ */
+template <EntityEventType Event>
+bool DeferredEventBus::Post()
+{
+	static_assert(GetEventPayloadType(Event) == EVENT_PAYLOAD_NONE, "This event type requires a message");
+	return Enqueue(Event, EntityEventMessage(), std::weak_ptr<GameEntity>(), true);
+}
+
+/**
+ * \brief Posts an event to every entity with its message type checked at compile time
+ * \tparam Event Message type to send
+ * \param payload Body of the message
+ */
+template <EntityEventType Event, typename Payload>
+bool DeferredEventBus::Post(const Payload& payload)
+{
+	static_assert(EventPayloadOf<Payload>::type == GetEventPayloadType(Event), "Wrong message type for this event type");
+	static_assert(EventPayloadOf<Payload>::type != EVENT_PAYLOAD_ENTITY, "Entity messages can't be deferred");
+	return Enqueue(Event, EntityEventMessage(payload), std::weak_ptr<GameEntity>(), true);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GameEntity.h"
+
+/// <summary>
+/// Records structural changes, meaning entity creation and destruction,
+/// enabling and disabling entities, and adding or removing components, so they
+/// can be applied together at one sync point per frame instead of in the middle
+/// of a pool iteration or callback.
+/// Recording is thread safe. Commands are applied in the order they were
+/// recorded, except destruction, which is batched after everything else.
+/// </summary>
+class EntityCommandBuffer
+{
+#pragma region Singleton
+public:
+	// Gets the one and only instance of this class
+	static EntityCommandBuffer& GetInstance()
+	{
+		if (!instance)
+		{
+			instance = new EntityCommandBuffer();
+		}
+
+		return *instance;
+	}
+
+	// Remove these functions (C++ 11 version)
+	EntityCommandBuffer(EntityCommandBuffer const&) = delete;
+	void operator=(EntityCommandBuffer const&) = delete;
+
+private:
+	static EntityCommandBuffer* instance;
+	EntityCommandBuffer();
+#pragma endregion
+public:
+	~EntityCommandBuffer();
+
+	void CreateEntity(std::string name, std::function<void(std::shared_ptr<GameEntity>)> onCreated = {});
+	void DestroyEntity(std::shared_ptr<GameEntity> entity);
+	void SetEnabled(std::shared_ptr<GameEntity> entity, bool enabled);
+
+	/**
+	 * \brief Adds a component of type T to an entity at the next sync point
+	 * \param entity Entity to add to, skipped if it's destroyed in the same batch
+	 * \param onAdded Called with the new component once it exists
+	 */
+	template <typename T>
+	void AddComponent(std::shared_ptr<GameEntity> entity, std::function<void(std::shared_ptr<T>)> onAdded = {})
+	{
+		Record(entity, [entity, onAdded]() {
+			std::shared_ptr<T> component = entity->AddComponent<T>();
+			if (onAdded) onAdded(component);
+		});
+	}
+
+	/**
+	 * \brief Removes the first component of type T from an entity at the next sync point
+	 */
+	template <typename T>
+	void RemoveComponent(std::shared_ptr<GameEntity> entity)
+	{
+		Record(entity, [entity]() { entity->RemoveComponent<T>(); });
+	}
+
+	void RemoveComponent(std::shared_ptr<GameEntity> entity, std::shared_ptr<IComponent> component);
+
+	void Apply();
+	size_t GetCommandCount();
+
+	/// <summary>
+	/// Marks a stretch that iterates component pools and calls back into game code,
+	/// like the component ticks or collision events. While any is open, on any thread,
+	/// destroying an entity or adding or removing a component is recorded here instead
+	/// of done straight away, since binding or freeing changes its pool under any live
+	/// ComponentView, and other threads may be reading it.
+	/// </summary>
+	class IterationScope
+	{
+	public:
+		IterationScope();
+		~IterationScope();
+
+		IterationScope(IterationScope const&) = delete;
+		void operator=(IterationScope const&) = delete;
+	};
+
+	static bool IsIterating();
+
+private:
+	friend class GameEntity;
+
+	struct EntityCommand
+	{
+		std::shared_ptr<GameEntity> entity;
+		std::function<void()> apply;
+	};
+
+	void Record(std::shared_ptr<GameEntity> entity, std::function<void()> apply);
+
+	// How many IterationScopes are open
+	static std::atomic<int> iterationDepth;
+
+	std::mutex recordMutex;
+	std::vector<EntityCommand> commands;
+	std::vector<std::shared_ptr<GameEntity>> destroyed;
+
+	// Swapped with the recording lists while applying, so commands
+	// recorded by callbacks during Apply land in the next batch
+	std::vector<EntityCommand> applyingCommands;
+	std::vector<std::shared_ptr<GameEntity>> applyingDestroyed;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <variant>
+#include <DirectXMath.h>
+#include "GameEntity.fwd.h"
+#include "AudioEventPacket.h"
+
+enum EntityEventType {
+	Update,
+	EditingUpdate,
+	OnEnable,
+	OnDisable,
+	OnTransform,
+	OnMove,
+	OnRotate,
+	OnScale,
+	OnParentTransform,
+	OnParentMove,
+	OnParentRotate,
+	OnParentScale,
+	OnParentEnabledChanged,
+	OnCollisionEnter,
+	OnTriggerEnter,
+	InCollision,
+	InTrigger,
+	OnCollisionExit,
+	OnTriggerExit,
+	OnAudioLoad,
+	OnAudioPlay,
+	OnAudioPause,
+	OnAudioEnd,
+	EventCount,
+	REQUIRES_MESSAGE = 0b11111111111111111100000
+};
+
+// One bit per EntityEventType entry
+typedef uint32_t EntityEventMask;
+static_assert(EventCount <= sizeof(EntityEventMask) * 8, "EntityEventMask is too small for every event type");
+
+// What an event's message carries. Matches the order of EntityEventMessage's variant.
+enum EventPayloadType {
+	EVENT_PAYLOAD_NONE,
+	EVENT_PAYLOAD_VECTOR,
+	EVENT_PAYLOAD_ENTITY,
+	EVENT_PAYLOAD_AUDIO
+};
+
+/// <summary>
+/// The payload each event type must be sent with
+/// </summary>
+constexpr EventPayloadType GetEventPayloadType(EntityEventType event)
+{
+	switch (event) {
+	case OnMove:
+	case OnRotate:
+	case OnScale:
+		return EVENT_PAYLOAD_VECTOR;
+	case OnParentTransform:
+	case OnParentMove:
+	case OnParentRotate:
+	case OnParentScale:
+	case OnParentEnabledChanged:
+	case OnCollisionEnter:
+	case OnTriggerEnter:
+	case InCollision:
+	case InTrigger:
+	case OnCollisionExit:
+	case OnTriggerExit:
+		return EVENT_PAYLOAD_ENTITY;
+	case OnAudioLoad:
+	case OnAudioPlay:
+	case OnAudioPause:
+	case OnAudioEnd:
+		return EVENT_PAYLOAD_AUDIO;
+	default:
+		return EVENT_PAYLOAD_NONE;
+	}
+}
+
+constexpr bool EventPayloadsMatchRequiresMessage()
+{
+	for (int event = 0; event < EventCount; event++) {
+		bool required = (REQUIRES_MESSAGE & 1 << event) != 0;
+		if (required != (GetEventPayloadType((EntityEventType)event) != EVENT_PAYLOAD_NONE)) return false;
+	}
+	return true;
+}
+static_assert(EventPayloadsMatchRequiresMessage(), "REQUIRES_MESSAGE is out of sync with GetEventPayloadType");
+
+/// <summary>
+/// Maps a C++ type to the payload it's sent as, for compile time checks
+/// </summary>
+template <typename T>
+struct EventPayloadOf {};
+
+template <> struct EventPayloadOf<DirectX::XMFLOAT3> { static constexpr EventPayloadType type = EVENT_PAYLOAD_VECTOR; };
+template <> struct EventPayloadOf<GameEntity*> { static constexpr EventPayloadType type = EVENT_PAYLOAD_ENTITY; };
+template <> struct EventPayloadOf<std::shared_ptr<GameEntity>> { static constexpr EventPayloadType type = EVENT_PAYLOAD_ENTITY; };
+template <> struct EventPayloadOf<AudioEventPacket> { static constexpr EventPayloadType type = EVENT_PAYLOAD_AUDIO; };
+
+/// <summary>
+/// The body of an entity event, held by value so sending one never allocates.
+/// Entities are held as raw pointers, as events are delivered before the
+/// sender returns; the receiving hook gets a shared_ptr back from the entity.
+/// </summary>
+class EntityEventMessage
+{
+public:
+	EntityEventMessage() {}
+	EntityEventMessage(DirectX::XMFLOAT3 vector) : payload(vector) {}
+	EntityEventMessage(GameEntity* entity) : payload(entity) {}
+	EntityEventMessage(const std::shared_ptr<GameEntity>& entity) : payload(entity.get()) {}
+	EntityEventMessage(AudioEventPacket audio) : payload(std::move(audio)) {}
+
+	EventPayloadType GetType() const { return (EventPayloadType)payload.index(); }
+
+	DirectX::XMFLOAT3 GetVector() const { return std::get<EVENT_PAYLOAD_VECTOR>(payload); }
+	std::shared_ptr<GameEntity> GetEntity() const;
+	const AudioEventPacket& GetAudio() const { return std::get<EVENT_PAYLOAD_AUDIO>(payload); }
+
+private:
+	std::variant<std::monostate, DirectX::XMFLOAT3, GameEntity*, AudioEventPacket> payload;
+};
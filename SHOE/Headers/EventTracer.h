@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EntityEvent.h"
+
+// Tracing adds a few atomics and clock reads to every dispatch,
+// so it's only compiled in for debug builds unless defined otherwise
+#ifndef SHOE_EVENT_TRACING
+#if defined(DEBUG) || defined(_DEBUG)
+#define SHOE_EVENT_TRACING 1
+#else
+#define SHOE_EVENT_TRACING 0
+#endif
+#endif
+
+struct EventTypeFrameStats
+{
+	// Top level sends, meaning dispatches not nested in another dispatch of the same type
+	uint32_t sends;
+	// Entities the event reached, whether or not anything on them handled it
+	uint32_t deliveries;
+	// Components whose ReceiveEvent ran
+	uint32_t fanOut;
+	// Most components reached by a single send, including through children
+	uint32_t peakFanOut;
+	// Time spent inside top level sends, including any other events they caused
+	double milliseconds;
+};
+
+struct EventFrameStats
+{
+	unsigned int frame;
+	// Milliseconds since tracing started
+	double startTime;
+	double duration;
+	EventTypeFrameStats types[EventCount];
+};
+
+/// <summary>
+/// Counts how many times each EntityEventType is sent, how many components it
+/// reaches, and how long it takes, totalled per frame. The last HistoryLength
+/// frames are kept in a ring buffer for the stats window and Chrome trace export.
+/// Recording is done through the TRACE_EVENT_* macros below, which compile to
+/// nothing when SHOE_EVENT_TRACING is 0. Safe to record from any thread.
+/// </summary>
+class EventTracer
+{
+public:
+	static const size_t HistoryLength = 240;
+
+	static const char* GetEventName(EntityEventType event);
+
+	static void EndFrame();
+	static bool GetLastFrame(EventFrameStats& stats);
+	static std::vector<EventFrameStats> GetHistory();
+
+	static bool ExportChromeTrace(std::string filepath);
+
+	static void RecordDelivery(EntityEventType event);
+	static void RecordReceive(EntityEventType event);
+
+private:
+	friend class EventDispatchScope;
+
+	static EventFrameStats history[HistoryLength];
+	static size_t historyCount;
+	static size_t nextHistoryIndex;
+};
+
+/// <summary>
+/// Times a dispatch and counts it as a send if no dispatch of the
+/// same type is already running on this thread
+/// </summary>
+class EventDispatchScope
+{
+public:
+	EventDispatchScope(EntityEventType event);
+	~EventDispatchScope();
+
+	EventDispatchScope(EventDispatchScope const&) = delete;
+	void operator=(EventDispatchScope const&) = delete;
+
+private:
+	EntityEventType event;
+	bool outermost;
+	int64_t startTicks;
+	uint32_t startFanOut;
+};
+
+#if SHOE_EVENT_TRACING
+#define TRACE_EVENT_DISPATCH(event) EventDispatchScope eventDispatchScope(event)
+#define TRACE_EVENT_DELIVERY(event) EventTracer::RecordDelivery(event)
+#define TRACE_EVENT_RECEIVE(event) EventTracer::RecordReceive(event)
+#else
+#define TRACE_EVENT_DISPATCH(event)
+#define TRACE_EVENT_DELIVERY(event)
+#define TRACE_EVENT_RECEIVE(event)
+#endif
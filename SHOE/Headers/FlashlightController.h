@@ -3,4 +3,6 @@
 class FlashlightController : public IComponent
 {
 	//Eventually flickering will go here, but for now empty is fine
+public:
+	static void ToggleAll();
 };
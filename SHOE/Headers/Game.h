@@ -66,5 +66,10 @@ private:
 	std::vector<std::shared_ptr<Material>> specialMaterials;
 
 	EngineState engineState;
+
+	// Where to write the memory stats on shutdown, if anywhere
+	std::string memoryReportPath;
+	// Where to write the event trace on shutdown, if anywhere
+	std::string eventTracePath;
 };
 
@@ -9,6 +9,8 @@
 #include "Camera.h"
 #include "AudioResponse.h"
 #include "ComponentManager.h"
+#include "ComponentTypeID.h"
+#include "ComponentEvents.h"
 
 class GameEntity : public std::enable_shared_from_this<GameEntity>
 {
@@ -21,11 +23,36 @@ private:
 
 	std::vector<std::shared_ptr<IComponent>> componentList;
 	std::vector<std::function<void(std::shared_ptr<IComponent>)>> componentDeallocList;
+	// Parallel to componentList, the ComponentTypes entry of each component
+	std::vector<ComponentTypes> componentTypeList;
+	// Which registered types are attached, and where the first of each is in componentList
+	ComponentMask componentMask;
+	int firstComponentOfType[COMPONENT_TYPE_COUNT];
+	// Parallel to componentList, the events each component handles, and their
+	// union with the transform's, so events nobody here handles return at once
+	std::vector<EntityEventMask> componentEventMasks;
+	EntityEventMask eventMask;
+	// Every component bound to this entity, including ones not in componentList
+	// like the transform, so their pools' enabled state can follow the hierarchy
+	std::vector<IComponent*> boundComponents;
 
-	void PropagateEvent(EntityEventType event, std::shared_ptr<void> message = nullptr);
-	void PropagateEventToChildren(EntityEventType event, std::shared_ptr<void> message = nullptr);
+	void PropagateEvent(EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
+	void PropagateEventToChildren(EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
+	template <EntityEventType Event>
+	void PropagateEvent();
+	template <EntityEventType Event, typename Payload>
+	void PropagateEvent(const Payload& payload);
+	template <EntityEventType Event, typename Payload>
+	void PropagateEventToChildren(const Payload& payload);
+	void DeliverEvent(EntityEventType event, const EntityEventMessage& message);
+	void DeliverEventToChildren(EntityEventType event, const EntityEventMessage& message);
 
 	void UpdateHierarchyIsEnabled(bool active, bool head = false);
+
+	void AttachComponent(std::shared_ptr<IComponent> component, ComponentTypes type, EntityEventMask events, std::function<void(std::shared_ptr<IComponent>)> dealloc);
+	bool DeferWhileIterating(std::function<void()> change);
+	void RemoveComponentAt(int index);
+	void UpdateComponentTable();
 public:
 	GameEntity(std::string name);
 	~GameEntity();
@@ -47,12 +74,19 @@ public:
 	std::shared_ptr<T> AddComponent();
 	template <> std::shared_ptr<Transform> AddComponent();
 	template <> std::shared_ptr<Light> AddComponent();
+	template <typename T>
+	static std::vector<std::shared_ptr<T>> AddComponentToMany(const std::vector<std::shared_ptr<GameEntity>>& entities);
 
 	template <typename T>
 	bool RemoveComponent();
 	template <> bool RemoveComponent<Transform>();
 	bool RemoveComponent(std::shared_ptr<IComponent> component);
 
+	template <typename T>
+	bool HasComponent();
+	template <> bool HasComponent<Transform>();
+	ComponentMask GetComponentMask();
+
 	template <typename T>
 	std::shared_ptr<T> GetComponent();
 	template <> std::shared_ptr<Transform> GetComponent();
@@ -73,22 +107,92 @@ public:
 	friend class Transform;
 	friend class AssetManager;
 	friend class CollisionManager;
+	friend class DeferredEventBus;
+	friend class IComponent;
+	template <typename First, typename... Rest> friend class ComponentQuery;
 };
 
 /**
- * \brief Adds a component of the given type to the entity
+ * \brief Sends an event that carries no message, checked at compile time
+ * \tparam Event Message type to send
+ */
+template <EntityEventType Event>
+void GameEntity::PropagateEvent()
+{
+	static_assert(GetEventPayloadType(Event) == EVENT_PAYLOAD_NONE, "This event type requires a message");
+	DeliverEvent(Event, EntityEventMessage());
+}
+
+/**
+ * \brief Sends an event whose message type is checked at compile time,
+ * so no runtime check is needed before delivering it
+ * \tparam Event Message type to send
+ * \param payload Body of the message
+ */
+template <EntityEventType Event, typename Payload>
+void GameEntity::PropagateEvent(const Payload& payload)
+{
+	static_assert(EventPayloadOf<Payload>::type == GetEventPayloadType(Event), "Wrong message type for this event type");
+	DeliverEvent(Event, EntityEventMessage(payload));
+}
+
+/**
+ * \brief Sends an event to all children, with its message type checked at compile time
+ * \tparam Event Message type to send
+ * \param payload Body of the message
+ */
+template <EntityEventType Event, typename Payload>
+void GameEntity::PropagateEventToChildren(const Payload& payload)
+{
+	static_assert(EventPayloadOf<Payload>::type == GetEventPayloadType(Event), "Wrong message type for this event type");
+	DeliverEventToChildren(Event, EntityEventMessage(payload));
+}
+
+/**
+ * \brief Adds a component of the given type to the entity.
+ * While pools are being iterated the add is recorded into the EntityCommandBuffer instead.
  * \tparam T Type of component to add
- * \return The newly attached component
+ * \return The newly attached component, or nullptr if the add was deferred
  */
 template<typename T>
 std::shared_ptr<T> GameEntity::AddComponent()
 {
+	if (DeferWhileIterating([entity = shared_from_this()]() { entity->AddComponent<T>(); })) return nullptr;
+
 	std::shared_ptr<T> component = ComponentManager::Instantiate<T>(shared_from_this());
-	componentList.push_back(component);
-	componentDeallocList.push_back(ComponentManager::Free<T>);
+	AttachComponent(component, GetComponentTypeID<T>(), ComponentEventTraits<T>::mask, ComponentManager::Free<T>);
 	return component;
 }
 
+/**
+ * \brief Adds a component of the given type to each of many entities in one pool batch
+ * \tparam T Type of component to add
+ * \param entities Entities to add to. Lights past MAX_LIGHTS are skipped, as in AddComponent
+ * \return The new components, in entity order, nullptr wherever one was skipped
+ */
+template<typename T>
+std::vector<std::shared_ptr<T>> GameEntity::AddComponentToMany(const std::vector<std::shared_ptr<GameEntity>>& entities)
+{
+	static_assert(!std::is_same_v<T, Transform>, "Every entity already has a transform");
+
+	std::vector<std::shared_ptr<T>> components;
+	if constexpr (std::is_same_v<T, Light>) {
+		size_t room = (size_t)Light::GetRoomForLights();
+		std::vector<std::shared_ptr<GameEntity>> lit(entities.begin(), entities.begin() + std::min<size_t>(room, entities.size()));
+		components = ComponentManager::InstantiateMany<Light>(lit);
+		components.resize(entities.size());
+	}
+	else {
+		components = ComponentManager::InstantiateMany<T>(entities);
+	}
+
+	for (size_t i = 0; i < entities.size(); i++) {
+		if (components[i] != nullptr)
+			entities[i]->AttachComponent(components[i], GetComponentTypeID<T>(), ComponentEventTraits<T>::mask, ComponentManager::Free<T>);
+	}
+	return components;
+}
+
 /**
  * \brief Special case for transform, cannot have multiple transforms
  * \return This entity's transform
@@ -102,20 +206,21 @@ std::shared_ptr<Transform> GameEntity::AddComponent<Transform>()
 
 /**
  * \brief Special case for lights since they need to be tracked
- * \return A pointer to the new light, or nullptr if MAX_LIGHTS was already reached
+ * \return A pointer to the new light, or nullptr if MAX_LIGHTS was already reached or the add was deferred
  */
 template <>
 std::shared_ptr<Light> GameEntity::AddComponent<Light>()
 {
-	if (Light::GetLightArrayCount() == MAX_LIGHTS) {
+	if (DeferWhileIterating([entity = shared_from_this()]() { entity->AddComponent<Light>(); })) return nullptr;
+
+	if (Light::GetRoomForLights() == 0) {
 #if defined(DEBUG) || defined(_DEBUG)
 		printf("\nMax lights already exist, cancelling addition of light component.");
 #endif
 		return nullptr;
 	}
 	std::shared_ptr<Light> component = ComponentManager::Instantiate<Light>(shared_from_this());
-	componentList.push_back(component);
-	componentDeallocList.push_back(ComponentManager::Free<Light>);
+	AttachComponent(component, GetComponentTypeID<Light>(), ComponentEventTraits<Light>::mask, ComponentManager::Free<Light>);
 	return component;
 }
 
@@ -127,18 +232,24 @@ std::shared_ptr<Light> GameEntity::AddComponent<Light>()
 template<typename T>
 bool GameEntity::RemoveComponent()
 {
-	for(int i = 0; i < componentList.size(); i++)
-	{
-		if(std::dynamic_pointer_cast<T>(componentList[i]) != nullptr)
+	if constexpr (RegisteredComponent<T>) {
+		int index = firstComponentOfType[GetComponentTypeID<T>()];
+		if (index == -1)
+			return false;
+		RemoveComponentAt(index);
+		return true;
+	}
+	else {
+		for (int i = 0; i < componentList.size(); i++)
 		{
-			componentList[i]->OnDestroy();
-			componentDeallocList[i](componentList[i]);
-			componentList.erase(componentList.begin() + i);
-			componentDeallocList.erase(componentDeallocList.begin() + i);
-			return true;
+			if (std::dynamic_pointer_cast<T>(componentList[i]) != nullptr)
+			{
+				RemoveComponentAt(i);
+				return true;
+			}
 		}
+		return false;
 	}
-	return false;
 }
 
 /**
@@ -151,6 +262,32 @@ bool GameEntity::RemoveComponent<Transform>()
 	return false;
 }
 
+/**
+ * \brief Checks whether a component of a given type is attached, without fetching it
+ * \tparam T Type of component to check for
+ * \return True if at least one is attached
+ */
+template<typename T>
+bool GameEntity::HasComponent()
+{
+	if constexpr (RegisteredComponent<T>) {
+		return (componentMask & GetComponentTypeMask<T>()) != 0;
+	}
+	else {
+		return GetComponent<T>() != nullptr;
+	}
+}
+
+/**
+ * \brief Special case for transform, every entity has exactly one
+ * \return True
+ */
+template <>
+bool GameEntity::HasComponent<Transform>()
+{
+	return true;
+}
+
 /**
  * \brief Gets the first component of a given type on this entity
  * \tparam T Type of component to get
@@ -159,12 +296,20 @@ bool GameEntity::RemoveComponent<Transform>()
 template<typename T>
 std::shared_ptr<T> GameEntity::GetComponent()
 {
-	for (std::shared_ptr<IComponent> component : componentList) {
-		std::shared_ptr<T> c = std::dynamic_pointer_cast<T>(component);
-		if (c != nullptr)
-			return c;
+	if constexpr (RegisteredComponent<T>) {
+		int index = firstComponentOfType[GetComponentTypeID<T>()];
+		if (index == -1)
+			return nullptr;
+		return std::static_pointer_cast<T>(componentList[index]);
+	}
+	else {
+		for (std::shared_ptr<IComponent> component : componentList) {
+			std::shared_ptr<T> c = std::dynamic_pointer_cast<T>(component);
+			if (c != nullptr)
+				return c;
+		}
+		return nullptr;
 	}
-	return nullptr;
 }
 
 /**
@@ -186,10 +331,20 @@ template<typename T>
 std::vector<std::shared_ptr<T>> GameEntity::GetComponents()
 {
 	std::vector<std::shared_ptr<T>> components = std::vector<std::shared_ptr<T>>();
-	for (std::shared_ptr<IComponent> c : componentList) {
-		std::shared_ptr<T> component = std::dynamic_pointer_cast<T>(c);
-		if (component != nullptr)
-			components.push_back(component);
+	if constexpr (RegisteredComponent<T>) {
+		if ((componentMask & GetComponentTypeMask<T>()) == 0)
+			return components;
+		for (int i = firstComponentOfType[GetComponentTypeID<T>()]; i < componentList.size(); i++) {
+			if (componentTypeList[i] == GetComponentTypeID<T>())
+				components.push_back(std::static_pointer_cast<T>(componentList[i]));
+		}
+	}
+	else {
+		for (std::shared_ptr<IComponent> c : componentList) {
+			std::shared_ptr<T> component = std::dynamic_pointer_cast<T>(c);
+			if (component != nullptr)
+				components.push_back(component);
+		}
 	}
 	return components;
 }
@@ -238,7 +393,8 @@ std::vector<std::shared_ptr<T>> GameEntity::GetComponentsInChildren()
 
 	for (auto& child : transform->GetChildrenEntities())
 	{
-		components.emplace_back(child->GetComponentsInChildren<T>());
+		std::vector<std::shared_ptr<T>> childComponents = child->GetComponentsInChildren<T>();
+		components.insert(components.end(), childComponents.begin(), childComponents.end());
 	}
 
 	return components;
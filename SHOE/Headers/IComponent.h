@@ -2,44 +2,19 @@
 #include <memory>
 #include <DirectXMath.h>
 #include "GameEntity.fwd.h"
-#include "AudioEventPacket.h"
+#include "EntityEvent.h"
+#include "ComponentHandle.h"
 
 class Transform;
-
-enum EntityEventType {
-	Update,
-	EditingUpdate,
-	OnEnable,
-	OnDisable,
-	OnTransform,
-	OnMove,
-	OnRotate,
-	OnScale,
-	OnParentTransform,
-	OnParentMove,
-	OnParentRotate,
-	OnParentScale,
-	OnParentEnabledChanged,
-	OnCollisionEnter,
-	OnTriggerEnter,
-	InCollision,
-	InTrigger,
-	OnCollisionExit,
-	OnTriggerExit,
-	OnAudioLoad,
-	OnAudioPlay,
-	OnAudioPause,
-	OnAudioEnd,
-	EventCount,
-	REQUIRES_MESSAGE = 0b11111111111111111100000
-};
+class ComponentBitset;
+template <typename T> class ComponentPool;
 
 class IComponent
 {
 public:
-	void ReceiveEvent(EntityEventType event, std::shared_ptr<void> message = nullptr);
+	void ReceiveEvent(EntityEventType event, const EntityEventMessage& message = EntityEventMessage());
 
-	void Bind(std::shared_ptr<GameEntity> gameEntity);
+	void Bind(std::shared_ptr<GameEntity> gameEntity, bool start = true);
 	void Free();
 	virtual void OnDestroy();
 
@@ -48,8 +23,11 @@ public:
 	void SetEnabled(bool enabled);
 	std::shared_ptr<GameEntity> GetGameEntity();
 	std::shared_ptr<Transform> GetTransform();
+	ComponentHandle GetHandle();
 protected:
 	virtual void Start();
+	// Overrides of these and the event hooks below must be protected or public,
+	// so ComponentTickTraits and ComponentEventTraits can detect them
 	virtual void Update();
 	virtual void EditingUpdate();
 	virtual void OnCollisionEnter(std::shared_ptr<GameEntity> other);
@@ -73,7 +51,17 @@ protected:
 	virtual void OnAudioPause(AudioEventPacket audio);
 	virtual void OnAudioEnd(AudioEventPacket audio);
 private:
+	void RefreshEnabledState();
+
 	std::shared_ptr<GameEntity> gameEntity;
+	ComponentHandle handle;
+	// The owning pool's enabled bitset, kept in sync with IsEnabled()
+	ComponentBitset* enabledSet = nullptr;
 
 	bool enabled = true;
+
+	template <typename T> friend class ComponentPool;
+	template <typename First, typename... Rest> friend class ComponentQuery;
+	friend class ComponentTicks;
+	friend class GameEntity;
 };
\ No newline at end of file
@@ -2,20 +2,7 @@
 #include "IComponent.h"
 #include "ShadowProjector.h"
 #include <vector>
-
-#define MAX_LIGHTS 24
-
-struct LightData {
-	float type;
-	DirectX::XMFLOAT3 color;
-	float intensity;
-	DirectX::XMFLOAT3 direction;
-	float enabled;
-	DirectX::XMFLOAT3 position;
-	float range;
-	float castsShadows;
-	DirectX::XMFLOAT2 padding;
-};
+#include "LightData.h"
 
 class Light : public IComponent, public std::enable_shared_from_this<Light>
 {
@@ -24,12 +11,6 @@ private:
 	static std::vector<LightData> lightData;
 
 	void Start() override;
-	void OnTransform() override;
-	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
-	void OnParentMove(std::shared_ptr<GameEntity> parent) override;
-	void OnMove(DirectX::XMFLOAT3 delta) override;
-	void OnEnable() override;
-	void OnDisable() override;
 
 	std::shared_ptr<ShadowProjector> shadowProjector;
 
@@ -42,11 +23,18 @@ private:
 	LightData GetData();
 
 	void MarkLightAndShadowsDirty();
+protected:
+	void OnTransform() override;
+	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
+	void OnMove(DirectX::XMFLOAT3 delta) override;
+	void OnEnable() override;
+	void OnDisable() override;
 public:
 	void OnDestroy() override;
 
 	static LightData* GetLightArray();
 	static int GetLightArrayCount();
+	static int GetRoomForLights();
 
 	float GetType();
 	void SetType(float type);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#define MAX_LIGHTS 24
+
+// A light as the shaders see it. Kept apart from Light so render
+// snapshots can carry lights without the component.
+struct LightData {
+	float type;
+	DirectX::XMFLOAT3 color;
+	float intensity;
+	DirectX::XMFLOAT3 direction;
+	float enabled;
+	DirectX::XMFLOAT3 position;
+	float range;
+	float castsShadows;
+	DirectX::XMFLOAT2 padding;
+};
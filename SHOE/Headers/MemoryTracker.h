@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Replacing the global operator new puts a header and a few atomics on every
+// allocation, so it's only compiled in for debug builds unless defined otherwise.
+// Pool slot counts and external allocations are reported either way.
+#ifndef SHOE_MEMORY_TRACKING
+#if defined(DEBUG) || defined(_DEBUG)
+#define SHOE_MEMORY_TRACKING 1
+#else
+#define SHOE_MEMORY_TRACKING 0
+#endif
+#endif
+
+// Every heap allocation made through operator new is charged to one of these.
+// Allocations made outside any MemoryScope land in MEMORY_UNTAGGED.
+enum MemoryCategory {
+	MEMORY_UNTAGGED,
+	MEMORY_COMPONENT_POOLS,
+	MEMORY_MESHES,
+	MEMORY_HEIGHTMAPS,
+	MEMORY_TEXTURES,
+	MEMORY_SCENE_DATA,
+	// Must always be the final enum
+	MEMORY_CATEGORY_COUNT
+};
+
+struct MemoryCategoryStats
+{
+	size_t liveBytes;
+	size_t peakBytes;
+	size_t totalAllocations;
+	// Counts for the last completed frame
+	size_t frameAllocations;
+	size_t frameBytes;
+};
+
+struct MemoryPoolStats
+{
+	std::string name;
+	size_t slotSize;
+	uint32_t liveSlots;
+	uint32_t freeSlots;
+};
+
+/// <summary>
+/// Engine-wide allocation accounting. With SHOE_MEMORY_TRACKING on, the global
+/// operator new and delete are replaced (see MemoryTracker.cpp) so every allocation
+/// carries a small header recording its size and category, and is charged to
+/// whichever MemoryScope was innermost on the allocating thread. Component pools
+/// also report their slot counts. Counters are relaxed atomics, so reading them from
+/// the UI while a loading thread allocates is safe but only approximately consistent.
+/// </summary>
+class MemoryTracker
+{
+public:
+	static const char* GetCategoryName(MemoryCategory category);
+	static MemoryCategoryStats GetStats(MemoryCategory category);
+	static MemoryCategory GetCurrentCategory();
+
+	static void EndFrame();
+
+	static void RegisterPool(const char* name, size_t slotSize, uint32_t (*getCapacity)(), uint32_t (*getFreeCount)());
+	static std::vector<MemoryPoolStats> GetPoolStats();
+
+	static void TrackExternal(MemoryCategory category, size_t bytes);
+	static void UntrackExternal(MemoryCategory category, size_t bytes);
+
+	static bool DumpToJSON(std::string filepath);
+
+private:
+	friend class MemoryScope;
+
+	struct PoolEntry
+	{
+		const char* name;
+		size_t slotSize;
+		uint32_t (*getCapacity)();
+		uint32_t (*getFreeCount)();
+	};
+
+	static std::vector<PoolEntry> pools;
+};
+
+/// <summary>
+/// Charges every allocation made on this thread to a category until it goes
+/// out of scope. Scopes nest, and the innermost one wins.
+/// </summary>
+class MemoryScope
+{
+public:
+	MemoryScope(MemoryCategory category);
+	~MemoryScope();
+
+	MemoryScope(MemoryScope const&) = delete;
+	void operator=(MemoryScope const&) = delete;
+
+private:
+	MemoryCategory previous;
+};
+
+/// <summary>
+/// Reports memory that bypasses operator new, like a rapidjson document's
+/// malloc-backed pool, for as long as this object lives
+/// </summary>
+class MemoryExternalAllocation
+{
+public:
+	MemoryExternalAllocation(MemoryCategory category);
+	~MemoryExternalAllocation();
+
+	MemoryExternalAllocation(MemoryExternalAllocation const&) = delete;
+	void operator=(MemoryExternalAllocation const&) = delete;
+
+	void SetSize(size_t bytes);
+
+private:
+	MemoryCategory category;
+	size_t bytes;
+};
@@ -30,8 +30,8 @@ private:
 	std::shared_ptr<Material> mat;
 
 	DirectX::BoundingOrientedBox bounds;
+	// The transform's world version bounds was built from
+	uint32_t boundsVersion;
 	void CalculateBounds();
 	void Start() override;
-	void OnTransform() override;
-	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
 };
\ No newline at end of file
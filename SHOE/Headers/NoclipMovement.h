@@ -1,15 +1,21 @@
 #pragma once
 
 #include "IComponent.h"
+#include "ComponentTypeID.h"
 #include <DirectXMath.h>
 
 class NoclipMovement : public IComponent
 {
 public:
+	// Access declared to the SystemScheduler
+	typedef ComponentAccess<> Reads;
+	typedef TransformWriteAccess Writes;
+
 	float moveSpeed;
 	float lookSpeed;
+protected:
+	void Update() override;
 private:
 	void Start() override;
-	void Update() override;
 };
 
@@ -87,7 +87,6 @@ private:
 	static Microsoft::WRL::ComPtr<ID3D11DeviceContext> defaultContext;
 
 	void Start() override;
-	void Update() override;
 
 	void Initialize(int maxParticles);
 	void EmitParticle(int emitCount);
@@ -134,4 +133,7 @@ private:
 
 	Microsoft::WRL::ComPtr<ID3D11Device> device;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+
+protected:
+	void Update() override;
 };
\ No newline at end of file
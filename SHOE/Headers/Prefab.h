@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "GameEntity.h"
+
+// Where one instance of a prefab is placed
+struct PrefabTransform
+{
+	DirectX::XMFLOAT3 position = DirectX::XMFLOAT3(0, 0, 0);
+	DirectX::XMFLOAT3 pitchYawRoll = DirectX::XMFLOAT3(0, 0, 0);
+	DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1, 1, 1);
+};
+
+/// <summary>
+/// A template for spawning many identical GameEntities at once through
+/// AssetManager::InstantiateMany. Components are listed in the order they
+/// should be added, each with an optional setup callback run on every copy.
+/// </summary>
+class Prefab
+{
+public:
+	Prefab(std::string name = "GameEntity");
+	~Prefab();
+
+	/**
+	 * \brief Adds a component type every instance will get
+	 * \tparam T Type of component
+	 * \param configure Run on each instance's new component, after its Start
+	 * \return This prefab, so calls can be chained
+	 */
+	template <typename T>
+	Prefab& AddComponent(std::function<void(std::shared_ptr<T>)> configure = {})
+	{
+		components.push_back([configure](const std::vector<std::shared_ptr<GameEntity>>& entities) {
+			std::vector<std::shared_ptr<T>> added = GameEntity::AddComponentToMany<T>(entities);
+			if (!configure) return;
+			for (std::shared_ptr<T>& component : added) {
+				if (component != nullptr) configure(component);
+			}
+		});
+		return *this;
+	}
+
+	std::string GetName();
+	void SetName(std::string name);
+	bool GetEnabled();
+	void SetEnabled(bool enabled);
+
+private:
+	std::string name;
+	bool enabled;
+
+	// Each adds its component to a whole batch of entities
+	std::vector<std::function<void(const std::vector<std::shared_ptr<GameEntity>>&)>> components;
+
+	friend class AssetManager;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "MeshRenderer.h"
+#include "ComponentView.h"
+#include "RenderSnapshot.h"
+
+// Bit layout of a render sort key, most significant first:
+// transparency | vertex shader | pixel shader | material | mesh
+// Opaque draws sort ahead of transparent ones, then state changes
+// are grouped from most to least expensive to swap
+constexpr uint32_t RENDER_KEY_MESH_BITS = 20;
+constexpr uint32_t RENDER_KEY_MATERIAL_BITS = 20;
+constexpr uint32_t RENDER_KEY_PIXEL_SHADER_BITS = 12;
+constexpr uint32_t RENDER_KEY_VERTEX_SHADER_BITS = 11;
+
+constexpr uint32_t RENDER_KEY_MATERIAL_SHIFT = RENDER_KEY_MESH_BITS;
+constexpr uint32_t RENDER_KEY_PIXEL_SHADER_SHIFT = RENDER_KEY_MATERIAL_SHIFT + RENDER_KEY_MATERIAL_BITS;
+constexpr uint32_t RENDER_KEY_VERTEX_SHADER_SHIFT = RENDER_KEY_PIXEL_SHADER_SHIFT + RENDER_KEY_PIXEL_SHADER_BITS;
+constexpr uint32_t RENDER_KEY_TRANSPARENT_SHIFT = RENDER_KEY_VERTEX_SHADER_SHIFT + RENDER_KEY_VERTEX_SHADER_BITS;
+
+static_assert(RENDER_KEY_TRANSPARENT_SHIFT == 63, "Render sort key fields must fill exactly 64 bits");
+
+struct RenderQueueEntry
+{
+	uint64_t key;
+	uint32_t slot;
+};
+
+/// <summary>
+/// Orders MeshRenderers for drawing.
+/// Anything that changes how a renderer sorts only marks the queue dirty,
+/// and the queue rebuilds its keys and radix sorts them at most once per frame.
+/// </summary>
+class RenderQueue
+{
+#pragma region Singleton
+public:
+	// Gets the one and only instance of this class
+	static RenderQueue& GetInstance()
+	{
+		if (!instance)
+		{
+			instance = new RenderQueue();
+		}
+
+		return *instance;
+	}
+
+	// Remove these functions (C++ 11 version)
+	RenderQueue(RenderQueue const&) = delete;
+	void operator=(RenderQueue const&) = delete;
+
+private:
+	static RenderQueue* instance;
+	RenderQueue();
+#pragma endregion
+public:
+	~RenderQueue();
+
+	void MarkDirty();
+	bool IsDirty();
+	void Update();
+
+	ComponentView<MeshRenderer> GetView();
+	size_t GetOpaqueCount();
+	const std::vector<RenderQueueEntry>& GetEntries();
+
+	void Capture(RenderSnapshot& snapshot);
+
+private:
+	uint64_t MakeKey(MeshRenderer& meshRenderer);
+	uint32_t GetGroupID(std::unordered_map<const void*, uint32_t>& groups, const void* resource, uint32_t bits);
+	void RadixSort();
+	uint32_t CaptureMesh(RenderSnapshot& snapshot, Mesh* mesh);
+	uint32_t CaptureMaterial(RenderSnapshot& snapshot, Material* material);
+	void CaptureLights(RenderSnapshot& snapshot);
+	void CaptureTerrains(RenderSnapshot& snapshot);
+
+	bool dirty;
+	size_t opaqueCount;
+
+	std::vector<RenderQueueEntry> entries;
+	std::vector<RenderQueueEntry> sortScratch;
+	// Slot indices in sorted order, what the view walks
+	std::vector<uint32_t> order;
+
+	// Dense per-rebuild IDs for the resources packed into each key
+	std::unordered_map<const void*, uint32_t> vertexShaderGroups;
+	std::unordered_map<const void*, uint32_t> pixelShaderGroups;
+	std::unordered_map<const void*, uint32_t> materialGroups;
+	std::unordered_map<const void*, uint32_t> meshGroups;
+
+	// Transforms of the captured draws, reused to batch their normal matrices
+	std::vector<Transform*> captureTransforms;
+	// Each mesh and material's position in the snapshot being captured
+	std::unordered_map<const Mesh*, uint32_t> captureMeshes;
+	std::unordered_map<const Material*, uint32_t> captureMaterials;
+};
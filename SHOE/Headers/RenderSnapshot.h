@@ -0,0 +1,204 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <d3d11.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <wrl/client.h>
+#include "ComponentHandle.h"
+#include "LightData.h"
+
+class SimplePixelShader;
+class SimpleVertexShader;
+
+// The GPU buffers of one mesh, shared by every item drawing it
+struct RenderSnapshotMesh
+{
+	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+	unsigned int indexCount;
+};
+
+// Everything drawing reads from one material, shared by every item using it.
+// Holding the shaders, views and samplers keeps them alive and unchanged
+// for the renderer even if the material is edited or freed meanwhile.
+struct RenderSnapshotMaterial
+{
+	std::shared_ptr<SimpleVertexShader> vertexShader;
+	std::shared_ptr<SimplePixelShader> pixelShader;
+	std::shared_ptr<SimplePixelShader> refractivePixelShader;
+	Microsoft::WRL::ComPtr<ID3D11SamplerState> sampler;
+	Microsoft::WRL::ComPtr<ID3D11SamplerState> clampSampler;
+	// Empty where the material has no such texture
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> albedo;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> normal;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> metal;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> rough;
+
+	DirectX::XMFLOAT4 tint;
+	float tiling;
+	float indexOfRefraction;
+	float refractionScale;
+	bool refractive;
+};
+
+// One MeshRenderer's draw, as it stood when its snapshot was captured
+struct RenderSnapshotItem
+{
+	// Matches the same renderer up between snapshots
+	ComponentHandle meshRenderer;
+	// Positions in the snapshot's meshes and materials
+	uint32_t mesh;
+	uint32_t material;
+	// The RenderQueue's sort key. Its group IDs only hold within one snapshot.
+	uint64_t sortKey;
+
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMFLOAT4X4 worldInverseTranspose;
+	// World position, rotation and scale, which interpolate where a matrix doesn't
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT4 rotation;
+	DirectX::XMFLOAT3 scale;
+	DirectX::BoundingOrientedBox bounds;
+};
+
+// One shadow casting light's map and the matrices it's rendered from
+struct RenderSnapshotShadow
+{
+	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthStencil;
+	DirectX::XMFLOAT4X4 view;
+	DirectX::XMFLOAT4X4 projection;
+	int width;
+	int height;
+};
+
+// Where the editor draws a point light's gizmo, and in what color
+struct RenderSnapshotPointLight
+{
+	DirectX::XMFLOAT4X4 world;
+	// Already scaled by the light's intensity
+	DirectX::XMFLOAT3 color;
+};
+
+// One Terrain's draw and the layers of its material
+struct RenderSnapshotTerrain
+{
+	// Albedo, normal, rough and metal, in that order
+	static const uint32_t TexturesPerLayer = 4;
+
+	DirectX::XMFLOAT4X4 world;
+	// Position in the snapshot's meshes
+	uint32_t mesh;
+	std::shared_ptr<SimpleVertexShader> vertexShader;
+	std::shared_ptr<SimplePixelShader> pixelShader;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> blendMap;
+	Microsoft::WRL::ComPtr<ID3D11SamplerState> clampSampler;
+	// Range of the snapshot's terrainTextures holding each layer's textures
+	uint32_t firstTexture;
+	uint32_t layerCount;
+};
+
+// Everything the renderer reads from the scene for one frame, copied out
+// so the scene can change, and assets be edited or freed, while it's drawn
+struct RenderSnapshot
+{
+	// Time::frameCount and Time::totalTime when this was captured
+	unsigned int frame;
+	float time;
+
+	// Enabled MeshRenderers in draw order, opaque first
+	std::vector<RenderSnapshotItem> items;
+	size_t opaqueCount;
+
+	// Each mesh and material the items use, once
+	std::vector<RenderSnapshotMesh> meshes;
+	std::vector<RenderSnapshotMaterial> materials;
+
+	LightData lights[MAX_LIGHTS];
+	unsigned int lightCount;
+
+	// Enabled shadow casting lights, in the order their maps are bound
+	std::vector<RenderSnapshotShadow> shadows;
+	// Enabled point lights, for the editor's gizmos
+	std::vector<RenderSnapshotPointLight> pointLights;
+
+	// Enabled Terrains, with every layer's textures in one list
+	std::vector<RenderSnapshotTerrain> terrains;
+	std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> terrainTextures;
+
+	void Clear();
+};
+
+/// <summary>
+/// Hands render snapshots from the simulation to the renderer.
+/// The simulation fills the write snapshot and publishes it once a frame.
+/// The renderer acquires the newest published snapshot and keeps it, along
+/// with the one before, until it next acquires, so it can draw either or
+/// anywhere in between while the simulation writes the next.
+/// Publishing and acquiring only swap slots, under a lock, so they may run
+/// on different threads. Nothing here touches components or the GPU.
+/// </summary>
+class RenderSnapshotBuffer
+{
+#pragma region Singleton
+public:
+	// Gets the one and only instance of this class
+	static RenderSnapshotBuffer& GetInstance()
+	{
+		if (!instance)
+		{
+			instance = new RenderSnapshotBuffer();
+		}
+
+		return *instance;
+	}
+
+	// Remove these functions (C++ 11 version)
+	RenderSnapshotBuffer(RenderSnapshotBuffer const&) = delete;
+	void operator=(RenderSnapshotBuffer const&) = delete;
+
+private:
+	static RenderSnapshotBuffer* instance;
+	RenderSnapshotBuffer();
+#pragma endregion
+public:
+	~RenderSnapshotBuffer();
+
+	// One being written, one published and waiting, and the current and
+	// previous ones the renderer holds
+	static const int SlotCount = 4;
+
+	// Simulation side
+	RenderSnapshot& GetWriteSnapshot();
+	void Publish();
+
+	// Render side
+	bool Acquire();
+	const RenderSnapshot& GetCurrent();
+	const RenderSnapshot& GetPrevious();
+	const RenderSnapshot& GetInterpolated(float alpha);
+	float GetAlpha(float time);
+
+	void SetInterpolationDelay(float delay);
+	float GetInterpolationDelay();
+
+private:
+	static const int NoSlot = -1;
+
+	RenderSnapshot snapshots[SlotCount];
+
+	std::mutex slotMutex;
+	int writeSlot;
+	int publishedSlot;
+	int currentSlot;
+	int previousSlot;
+
+	// Owned by the render side
+	RenderSnapshot interpolated;
+	// Seconds the renderer draws behind the newest snapshot
+	float interpolationDelay;
+	// For each MeshRenderer slot, its item in the previous snapshot plus one, or 0
+	std::vector<uint32_t> previousItems;
+};
@@ -208,6 +208,7 @@ private:
 
 	void LoadAssets(const rapidjson::Value& sceneDoc, std::function<void(std::string)> progressListener = {});
 	void LoadEntities(const rapidjson::Value& sceneDoc, std::function<void(std::string)> progressListener = {});
+	void ReserveComponents(const rapidjson::Value& entityBlock);
 
 	void SaveAssets(rapidjson::Document& sceneDocToSave);
 	void SaveEntities(rapidjson::Document& sceneDocToSave);
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "IComponent.h"
+#include "ComponentManager.h"
+#include "ComponentTypeID.h"
+
+struct ScheduledSystem
+{
+	std::string name;
+	// Update or EditingUpdate
+	EntityEventType phase;
+	ComponentMask reads;
+	ComponentMask writes;
+	std::function<void()> run;
+};
+
+/// <summary>
+/// Runs per-frame systems, letting any whose declared component reads and
+/// writes don't overlap run at the same time on a small worker pool.
+/// Systems that conflict always run in the order they were registered.
+/// Anything a system's event handlers touch counts as written: moving a
+/// Transform, for instance, fires OnMove at the components on that entity.
+/// Changes recorded into the EntityCommandBuffer don't count, since they
+/// only land at its sync point after every system has finished.
+/// </summary>
+class SystemScheduler
+{
+#pragma region Singleton
+public:
+	// Gets the one and only instance of this class
+	static SystemScheduler& GetInstance()
+	{
+		if (!instance)
+		{
+			instance = new SystemScheduler();
+		}
+
+		return *instance;
+	}
+
+	// Remove these functions (C++ 11 version)
+	SystemScheduler(SystemScheduler const&) = delete;
+	void operator=(SystemScheduler const&) = delete;
+
+private:
+	static SystemScheduler* instance;
+	SystemScheduler();
+#pragma endregion
+public:
+	~SystemScheduler();
+
+	void RegisterSystem(std::string name, EntityEventType phase, ComponentMask reads, ComponentMask writes, std::function<void()> run);
+
+	/**
+	 * \brief Ticks every enabled T in pool order as one system, using the
+	 * access T declares through its Reads and Writes ComponentAccess typedefs.
+	 * Broadcasts of the same phase then skip T, so it is never ticked twice.
+	 * \tparam T Component type to schedule
+	 * \param phase Update or EditingUpdate
+	 */
+	template <typename T>
+	void RegisterComponentSystem(EntityEventType phase)
+	{
+		static_assert(RegisteredComponent<T>, "Scheduled component types need a ComponentType registration");
+		RegisterSystem(typeid(T).name(), phase, T::Reads::mask | GetComponentTypeMask<T>(), T::Writes::mask,
+			[phase]() {
+				for (T& component : ComponentManager::ViewEnabled<T>()) {
+					component.ReceiveEvent(phase);
+				}
+			});
+		scheduledTypes[phase] |= GetComponentTypeMask<T>();
+	}
+
+	void Run(EntityEventType phase);
+	void ParallelFor(size_t jobCount, const std::function<void(size_t)>& job);
+
+	ComponentMask GetScheduledTypes(EntityEventType phase);
+
+	bool GetDeterministic();
+	void SetDeterministic(bool deterministic);
+	size_t GetWorkerCount();
+
+private:
+	void BuildWaves();
+	void StartWorkers(size_t count);
+	void RunWave(const std::vector<size_t>& wave);
+	void Dispatch(size_t jobCount, const std::function<void(size_t)>& job);
+	void RunJobs(unsigned int generation);
+	void WorkerLoop();
+
+	std::vector<ScheduledSystem> systems;
+	ComponentMask scheduledTypes[EntityEventType::EditingUpdate + 1];
+
+	// Indices into systems, grouped so nothing in a wave conflicts.
+	// One list of waves per phase, rebuilt whenever a system is registered.
+	std::vector<std::vector<size_t>> waves[EntityEventType::EditingUpdate + 1];
+	bool wavesDirty;
+
+	// Runs every system on the calling thread in registration order
+	bool deterministic;
+
+	std::vector<std::thread> workers;
+	std::mutex jobMutex;
+	std::condition_variable jobReady;
+	std::condition_variable waveDone;
+	// Job being handed out, called once with each index below jobCount
+	const std::function<void(size_t)>* currentJob;
+	size_t jobCount;
+	size_t nextJob;
+	size_t remainingJobs;
+	// First exception thrown by a job in the current dispatch
+	std::exception_ptr jobException;
+	unsigned int waveGeneration;
+	bool shuttingDown;
+};
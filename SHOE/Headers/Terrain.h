@@ -50,6 +50,7 @@ private:
 	DirectX::BoundingOrientedBox bounds;
 	void CalculateBounds();
 	void Start() override;
+protected:
 	void OnTransform() override;
 	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
 };
\ No newline at end of file
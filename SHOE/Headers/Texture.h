@@ -3,6 +3,7 @@
 #include <DirectXMath.h>
 #include <wrl/client.h>
 #include "DXCore.h"
+#include "MemoryTracker.h"
 #include <memory>
 
 class Texture {
@@ -62,6 +63,9 @@ public:
 protected:
 	D3D11_TEXTURE2D_DESC textureDesc;
 	Microsoft::WRL::ComPtr<ID3D11Texture2D> internalTexture;
+
+	// Estimated video memory, sized from the texture desc
+	MemoryExternalAllocation videoMemory;
 };
 
 class DX12Texture : public Texture {
@@ -5,4 +5,5 @@ public:
 	static float deltaTime;
 	static float totalTime;
 	static __int64 currentTime;
+	static unsigned int frameCount;
 };
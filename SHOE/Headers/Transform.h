@@ -1,9 +1,19 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <span>
 #include <vector>
 #include "GameEntity.fwd.h"
 #include "IComponent.h"
+#include "TransformHierarchy.h"
+
+// A full local transform, as set in bulk by Transform::SetLocalTRS
+struct TransformTRS
+{
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT4 rotation;
+	DirectX::XMFLOAT3 scale;
+};
 
 class Transform : public IComponent,  public std::enable_shared_from_this<Transform>
 {
@@ -12,52 +22,46 @@ private:
 	std::vector<std::shared_ptr<Transform>> children = std::vector<std::shared_ptr<Transform>>();
 	std::vector<std::shared_ptr<GameEntity>> childEntities = std::vector<std::shared_ptr<GameEntity>>();
 
-	bool globalsDirty;
-	DirectX::XMFLOAT3 worldPos;
-	DirectX::XMFLOAT3 worldScale;
-	DirectX::XMFLOAT4 worldRotQuat;
+	// This transform's slot in the TransformHierarchy, which holds its
+	// local position, rotation and scale, parent and world matrix
+	uint32_t hierarchyIndex = TRANSFORM_NO_INDEX;
 
-	// Raw transformation data
-	DirectX::XMFLOAT3 position;
-	DirectX::XMFLOAT3 pitchYawRoll;
-	DirectX::XMFLOAT3 scale;
+	DirectX::XMFLOAT3& LocalPosition();
+	DirectX::XMFLOAT4& LocalRotation();
+	DirectX::XMFLOAT3& LocalScale();
 
-	// Local orientation vectors
-	bool vectorsDirty;
-	DirectX::XMFLOAT3 up;
-	DirectX::XMFLOAT3 right;
-	DirectX::XMFLOAT3 forward;
+	// Euler view of the local rotation, for the editor and scene files.
+	// Keeps the angles it was given, and is only converted back from
+	// the quaternion when the rotation was set some other way.
+	DirectX::XMFLOAT3 pitchYawRoll;
+	bool pitchYawRollDirty;
 
-	// World matrix and inverse transpose of the world matrix
-	bool matricesDirty;
-	DirectX::XMFLOAT4X4 worldMatrix;
-	DirectX::XMFLOAT4X4 worldInverseTransposeMatrix;
+	void SetLocalTransform(DirectX::XMFLOAT3 position, DirectX::XMFLOAT4 rotation, DirectX::XMFLOAT3 scale);
 
-	// Helper to update both matrices if necessary
-	void UpdateMatrices();
-	void UpdateVectors();
-	void UpdateGlobals();
+	// Set by this transform's own setters, cleared once NotifyChanges has sent OnTransform
+	bool transformChangedThisFrame = false;
+	// Time::frameCount when this transform itself last changed
+	unsigned int lastChangedFrame;
+	// The NotifyChanges pass that last visited this transform
+	unsigned int notifiedPass = 0;
 
-	void SetTransformsFromMatrix(DirectX::XMFLOAT4X4 worldMatrix);
+	// Transforms that changed themselves since the last NotifyChanges
+	static std::vector<ComponentHandle> changedTransforms;
+	static unsigned int notifyPass;
 
-	bool transformChangedThisFrame = false;
+	void QueueChangeNotification();
+	void MarkBatchedChange();
+	void NotifySubtree(std::shared_ptr<GameEntity> changedAncestor);
 
 	// Helpers for conversion
 	DirectX::XMFLOAT3 QuaternionToEuler(DirectX::XMFLOAT4 quaternion);
 
 	void Start() override;
-	void Update() override;
-	void EditingUpdate() override;
-	void OnMove(DirectX::XMFLOAT3 delta) override;
-	void OnRotate(DirectX::XMFLOAT3 delta) override;
-	void OnScale(DirectX::XMFLOAT3 delta) override;
-	void OnParentTransform(std::shared_ptr<GameEntity> parent) override;
-	void OnParentMove(std::shared_ptr<GameEntity> parent) override;
-	void OnParentRotate(std::shared_ptr<GameEntity> parent) override;
-	void OnParentScale(std::shared_ptr<GameEntity> parent) override;
 public:
 	void OnDestroy() override;
 
+	static void NotifyChanges();
+
 	void MoveAbsolute(float x, float y, float z);
 	void MoveAbsolute(DirectX::XMFLOAT3 offset);
 	void MoveRelative(float x, float y, float z); // Move along our "local" axes (respect rotation)
@@ -71,12 +75,21 @@ public:
 	void SetPosition(DirectX::XMFLOAT3 pos);
 	void SetRotation(float pitch, float yaw, float roll);
 	void SetRotation(DirectX::XMFLOAT3 rot);
+	void SetRotation(DirectX::XMFLOAT4 quaternion);
 	void SetScale(float x, float y, float z);
 	void SetScale(DirectX::XMFLOAT3 scale);
 
+	// Bulk setters for animation and crowds. These send no OnMove, OnRotate or OnScale,
+	// only the OnTransform NotifyChanges sends each changed transform once a frame.
+	static void SetLocalPositions(std::span<const ComponentHandle> transforms, std::span<const DirectX::XMFLOAT3> positions);
+	static void SetLocalRotations(std::span<const ComponentHandle> transforms, std::span<const DirectX::XMFLOAT4> rotations);
+	static void SetLocalScales(std::span<const ComponentHandle> transforms, std::span<const DirectX::XMFLOAT3> scales);
+	static void SetLocalTRS(std::span<const ComponentHandle> transforms, std::span<const TransformTRS> values);
+
 	DirectX::XMFLOAT3 GetLocalPosition();
 	DirectX::XMFLOAT3 GetGlobalPosition();
 	DirectX::XMFLOAT3 GetLocalPitchYawRoll();
+	DirectX::XMFLOAT4 GetLocalRotation();
 	DirectX::XMFLOAT4 GetGlobalRotation();
 	DirectX::XMFLOAT3 GetLocalScale();
 	DirectX::XMFLOAT3 GetGlobalScale();
@@ -90,9 +103,11 @@ public:
 	DirectX::XMFLOAT4X4 GetWorldMatrix();
 	DirectX::XMFLOAT4X4 GetWorldInverseTransposeMatrix();
 
+	uint32_t GetWorldVersion();
+	bool WorldChangedSince(uint32_t version);
+	bool ChangedThisFrame();
+
 	void MarkMatricesDirty();
-	void MarkVectorsDirty();
-	void MarkGlobalsDirty();
 
 	void AddChild(std::shared_ptr<Transform> child);
 	void RemoveChild(std::shared_ptr<Transform> child);
@@ -103,5 +118,7 @@ public:
 	unsigned int GetChildCount();
 
 	std::vector<std::shared_ptr<GameEntity>> GetChildrenEntities();
+
+	friend class TransformHierarchy;
 };
 
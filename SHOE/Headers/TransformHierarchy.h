@@ -0,0 +1,115 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class Transform;
+
+// Index of a transform with no parent, and of a Transform with no slot
+constexpr uint32_t TRANSFORM_NO_INDEX = UINT32_MAX;
+
+/// <summary>
+/// Backing store for every Transform. Local position, rotation and scale,
+/// the parent's index and the world matrix, rotation and scale are kept in
+/// parallel arrays, one slot per Transform, sorted so a parent's slot always
+/// comes before its children's. That lets UpdateWorldMatrices refresh every
+/// dirty world matrix in one linear pass, each reading a parent already
+/// updated that pass.
+/// Transforms hold their slot's index and read and write through it.
+/// Slots are added and removed on the main thread only.
+/// Sorting also records where each depth starts. In large scenes each depth
+/// is then split into chunks updated in parallel on the SystemScheduler's
+/// workers, one depth after another.
+/// Rotations are stored as quaternions. Each world rotation and scale is the
+/// local one composed with the parent's, so neither has to be decomposed back
+/// out of the world matrix.
+/// Inverse transposes, for transforming normals, are only worked out when asked for.
+/// Staleness is tracked with version numbers rather than dirty flags. A change
+/// only bumps the changed slot's local version, and a world matrix is out of
+/// date when its own local version or its parent's world version has moved on
+/// since it was built. Nothing has to walk down the tree to invalidate it.
+/// </summary>
+class TransformHierarchy
+{
+public:
+	// Below this many slots the pass always runs on the calling thread
+	static const uint32_t ParallelThreshold = 16384;
+	// Slots per parallel job
+	static const uint32_t ChunkSize = 4096;
+
+	static void UpdateWorldMatrices();
+	static void UpdateWorldMatricesSerial();
+	static void UpdateWorldMatricesParallel();
+
+	static uint32_t GetCount();
+	static uint32_t GetDirtyCount();
+
+	static void UpdateInverseTransposes(const std::vector<Transform*>& transforms);
+
+private:
+	friend class Transform;
+
+	static uint32_t Allocate(Transform* owner);
+	static void Release(uint32_t index);
+	static void SetParent(uint32_t index, uint32_t parentIndex);
+	static void MarkChanged(uint32_t index);
+
+	static bool IsStale(uint32_t index);
+	static void UpdateWorldMatrix(uint32_t index);
+	static void ComputeWorldMatrix(uint32_t index);
+	static void UpdateInverseTranspose(uint32_t index);
+	static void ComputeInverseTranspose(uint32_t index);
+	static void UpdateRange(uint32_t begin, uint32_t end);
+	static void SortByDepth();
+
+	static std::vector<DirectX::XMFLOAT3> localPositions;
+	static std::vector<DirectX::XMFLOAT4> localRotations;
+	static std::vector<DirectX::XMFLOAT3> localScales;
+	static std::vector<uint32_t> parents;
+	static std::vector<DirectX::XMFLOAT4X4A> worldMatrices;
+	// Only match the world matrix while no non-uniformly scaled
+	// ancestor has a rotated child, as that shears the matrix
+	static std::vector<DirectX::XMFLOAT4> worldRotations;
+	static std::vector<DirectX::XMFLOAT3> worldScales;
+	static std::vector<DirectX::XMFLOAT4X4A> worldInverseTransposes;
+
+	// Bumped whenever the local transform or parent changes
+	static std::vector<uint32_t> localVersions;
+	// Bumped whenever the world matrix is rebuilt
+	static std::vector<uint32_t> worldVersions;
+	// The local version and the parent's world version the world matrix was built from
+	static std::vector<uint32_t> builtLocalVersions;
+	static std::vector<uint32_t> builtParentVersions;
+	// The world version the inverse transpose was built from
+	static std::vector<uint32_t> inverseTransposeVersions;
+	// The changeCount at which the world matrix was last found current.
+	// If nothing has changed since, it still is, so checks stop there
+	// instead of looking at every ancestor.
+	static std::vector<uint32_t> verifiedAt;
+	// Bumped whenever any slot's local version is
+	static uint32_t changeCount;
+	// The changeCount as of the last UpdateWorldMatrices, which leaves every slot current
+	static uint32_t passChangeCount;
+
+	static std::vector<Transform*> owners;
+	// Released slots, reused before the arrays grow
+	static std::vector<uint32_t> freeSlots;
+
+	// Set when a parent may no longer come before its children
+	static bool orderDirty;
+
+	// Where each depth's slots start as of the last sort, plus one past the last
+	// of them. Slots added since come after, and are updated after every depth.
+	static std::vector<uint32_t> levelStarts;
+	// Set when a parent changes, as the depths may no longer match levelStarts
+	static bool levelsDirty;
+
+	// Reused by UpdateInverseTransposes
+	static std::vector<uint32_t> staleInverseTransposes;
+
+	// Reused by SortByDepth
+	static std::vector<uint32_t> sortDepths;
+	static std::vector<uint32_t> sortOrder;
+	static std::vector<uint32_t> sortNewIndices;
+};
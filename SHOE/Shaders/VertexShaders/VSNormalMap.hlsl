@@ -37,6 +37,7 @@ cbuffer PerMaterial : register(b1)
 cbuffer PerObject : register(b2)
 {
 	matrix world;
+	matrix worldInverseTranspose;
 }
 
 // --------------------------------------------------------
@@ -73,7 +74,7 @@ VertexToPixelNormal main(VertexShaderInput input)
 	// - We don't need to alter it here, but we do need to send it to the pixel shader
 	output.surfaceColor = colorTint;
 
-	output.normal = normalize(mul((float3x3)world, input.normal));
+	output.normal = normalize(mul((float3x3)worldInverseTranspose, input.normal));
 
 	output.tangent = normalize(mul((float3x3)world, input.tangent));
 
@@ -68,7 +68,7 @@ VertexToPixel main( VertexShaderInput input )
 	// - We don't need to alter it here, but we do need to send it to the pixel shader
 	output.surfaceColor = colorTint;
 
-	output.normal = mul((float3x3)world, input.normal);
+	output.normal = mul((float3x3)worldInverseTranspose, input.normal);
 
 	output.worldPos = mul(world, float4(input.position, 1.0f)).xyz;
 
@@ -1,6 +1,10 @@
 #include "../Headers/AssetManager.h"
 #include "..\Headers\FlashlightController.h"
 #include "..\Headers\NoclipMovement.h"
+#include "..\Headers\MemoryTracker.h"
+#include "..\Headers\EntityCommandBuffer.h"
+#include <cassert>
+#include <unordered_set>
 
 using namespace DirectX;
 
@@ -131,7 +135,7 @@ FMOD::Sound* AssetManager::CreateSound(std::string path, FMOD_MODE mode, std::st
 
 		globalSounds.push_back(sound);
 
-		BroadcastGlobalEntityEvent(EntityEventType::OnAudioLoad, std::make_shared<AudioEventPacket>(baseFilename, nullptr));
+		BroadcastGlobalEntityEvent(EntityEventType::OnAudioLoad, AudioEventPacket(baseFilename, nullptr));
 #if defined(DEBUG) || defined(_DEBUG)
 		printf("Successfully loaded sound named %s\n", name.c_str());
 #endif
@@ -290,6 +294,7 @@ std::shared_ptr<SimpleComputeShader> AssetManager::CreateComputeShader(std::stri
 }
 
 std::shared_ptr<Mesh> AssetManager::CreateMesh(std::string id, std::string nameToLoad, bool isNameFullPath, bool isProjectAsset) {
+	MemoryScope memoryScope(MEMORY_MESHES);
 	std::string namePath;
 	std::shared_ptr<Mesh> newMesh;
 
@@ -459,6 +464,7 @@ std::string AssetManager::GetTextureFileKey(std::string textureFilename) {
 
 std::shared_ptr<Texture> AssetManager::CreateTexture(std::string nameToLoad, std::string textureName, AssetPathIndex assetPath, bool isNameFullPath, bool isProjectAsset)
 {
+	MemoryScope memoryScope(MEMORY_TEXTURES);
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> coreTexture;
 	std::shared_ptr<Texture> newTexture;
 
@@ -663,6 +669,54 @@ std::shared_ptr<GameEntity> AssetManager::CreateGameEntity(std::string name)
 	return newEnt;
 }
 
+/// <summary>
+/// Spawns many copies of a prefab at once. Each pool is reserved and bound
+/// in one batch per component type, every Start in a batch runs together,
+/// and pools with an order are sorted once per batch instead of per component.
+/// </summary>
+/// <param name="prefab">What each entity should have</param>
+/// <param name="count">How many entities to spawn</param>
+/// <param name="transforms">Optional placement per entity, missing entries keep the default transform</param>
+/// <returns>The new entities, in the same order as transforms</returns>
+std::vector<std::shared_ptr<GameEntity>> AssetManager::InstantiateMany(const Prefab& prefab, size_t count, const std::vector<PrefabTransform>& transforms)
+{
+	// Batches grow every pool at once, so they only run at sync points
+	assert(!EntityCommandBuffer::IsIterating());
+
+	std::vector<std::shared_ptr<GameEntity>> entities = std::vector<std::shared_ptr<GameEntity>>();
+	entities.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		entities.push_back(std::make_shared<GameEntity>(prefab.name));
+	}
+
+	// Same as GameEntity::Initialize, batched
+	std::vector<std::shared_ptr<Transform>> entityTransforms = ComponentManager::InstantiateMany<Transform>(entities);
+	for (size_t i = 0; i < count; i++) {
+		entities[i]->transform = entityTransforms[i];
+	}
+
+	for (const std::function<void(const std::vector<std::shared_ptr<GameEntity>>&)>& addComponent : prefab.components) {
+		addComponent(entities);
+	}
+
+	for (size_t i = 0; i < count && i < transforms.size(); i++) {
+		std::shared_ptr<Transform> transform = entityTransforms[i];
+		transform->SetPosition(transforms[i].position);
+		transform->SetRotation(transforms[i].pitchYawRoll);
+		transform->SetScale(transforms[i].scale);
+	}
+
+	if (!prefab.enabled) {
+		for (std::shared_ptr<GameEntity>& entity : entities) {
+			entity->SetEnabled(false);
+		}
+	}
+
+	globalEntities.insert(globalEntities.end(), entities.begin(), entities.end());
+
+	return entities;
+}
+
 /// <summary>
 /// Creates a GameEntity and gives it a MeshRenderer component
 /// </summary>
@@ -677,8 +731,10 @@ std::shared_ptr<GameEntity> AssetManager::CreateGameEntity(std::shared_ptr<Mesh>
 		newEnt = CreateGameEntity(name);
 
 		std::shared_ptr<MeshRenderer> renderer = newEnt->AddComponent<MeshRenderer>();
-		renderer->SetMesh(mesh);
-		renderer->SetMaterial(mat);
+		if (renderer != nullptr) {
+			renderer->SetMesh(mesh);
+			renderer->SetMaterial(mat);
+		}
 
 #if defined(DEBUG) || defined(_DEBUG)
 		printf("Successfully initialized gameEntity with mesh renderer named %s\n", name.c_str());
@@ -1102,6 +1158,7 @@ std::shared_ptr<Terrain> AssetManager::CreateTerrainOnEntity(std::shared_ptr<Gam
 	bool isProjectAsset) {
 
 	std::shared_ptr<Terrain> newTerrain = entityToEdit->AddComponent<Terrain>();
+	if (newTerrain == nullptr) return nullptr;
 	std::shared_ptr<HeightMap> tHeightmap;
 
 	newTerrain->SetMesh(LoadTerrain(heightmap, mapWidth, mapHeight, heightScale, tHeightmap, isProjectAsset));
@@ -1116,6 +1173,7 @@ std::shared_ptr<Terrain> AssetManager::CreateTerrainOnEntity(std::shared_ptr<Gam
 	std::shared_ptr<TerrainMaterial> material) {
 
 	std::shared_ptr<Terrain> newTerrain = entityToEdit->AddComponent<Terrain>();
+	if (newTerrain == nullptr) return nullptr;
 
 	newTerrain->SetMesh(terrainMesh);
 	newTerrain->SetMaterial(material);
@@ -1130,6 +1188,7 @@ std::shared_ptr<ParticleSystem> AssetManager::CreateParticleEmitterOnEntity(std:
 	bool isFullPathToAsset) {
 
 	std::shared_ptr<ParticleSystem> newEmitter = entityToEdit->AddComponent<ParticleSystem>();
+	if (newEmitter == nullptr) return nullptr;
 	//Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> loadedTexture;
 	std::vector<std::shared_ptr<Texture>> loadedTextures;
 
@@ -1248,7 +1307,7 @@ std::shared_ptr<Camera> AssetManager::CreateCameraOnEntity(std::shared_ptr<GameE
 {
 	float ar = aspectRatio == 0 ? ((float)dxInstance->width / (float)dxInstance->height) : aspectRatio;
 	std::shared_ptr<Camera> cam = entityToEdit->AddComponent<Camera>();
-	cam->SetAspectRatio(ar);
+	if (cam != nullptr) cam->SetAspectRatio(ar);
 	return cam;
 }
 
@@ -1258,7 +1317,7 @@ std::shared_ptr<Collider> AssetManager::CreateColliderOnEntity(std::shared_ptr<G
 
 std::shared_ptr<Collider> AssetManager::CreateTriggerBoxOnEntity(std::shared_ptr<GameEntity> entityToEdit) {
 	std::shared_ptr<Collider> c = entityToEdit->AddComponent<Collider>();
-	c->SetIsTrigger(true);
+	if (c != nullptr) c->SetIsTrigger(true);
 	return c;
 }
 
@@ -2089,13 +2148,34 @@ std::shared_ptr<Sky> AssetManager::GetSkyAtID(int id) {
 /// </summary>
 /// <param name="event">Message type to send</param>
 /// <param name="message">Body of the message, should one be needed</param>
-void AssetManager::BroadcastGlobalEntityEvent(EntityEventType event, std::shared_ptr<void> message)
+void AssetManager::BroadcastGlobalEntityEvent(EntityEventType event, const EntityEventMessage& message)
 {
 	for (std::shared_ptr<GameEntity> entity : globalEntities) {
 		entity->PropagateEvent(event, message);
 	}
 }
 
+/// <summary>
+/// Broadcasts several messages of the same type to all entities, visiting each
+/// entity once and skipping those with nothing that handles the event
+/// </summary>
+/// <param name="event">Message type to send</param>
+/// <param name="messages">Bodies of the messages, in the order to deliver them</param>
+void AssetManager::BroadcastGlobalEntityEvents(EntityEventType event, const std::vector<EntityEventMessage>& messages)
+{
+	EventPayloadType required = GetEventPayloadType(event);
+	EntityEventMask eventBit = (EntityEventMask)1 << event;
+
+	for (std::shared_ptr<GameEntity> entity : globalEntities) {
+		if (!(entity->eventMask & eventBit)) continue;
+
+		for (const EntityEventMessage& message : messages) {
+			if (required != EVENT_PAYLOAD_NONE && message.GetType() != required) continue;
+			entity->DeliverEvent(event, message);
+		}
+	}
+}
+
 std::shared_ptr<Texture> AssetManager::GetTextureAtID(int id) {
 	return this->globalTextures[id];
 }
@@ -2146,7 +2226,7 @@ std::shared_ptr<Camera> AssetManager::GetEditingCamera() {
 
 void AssetManager::UpdateEditingCamera()
 {
-	editingCamera->GetGameEntity()->PropagateEvent(EntityEventType::Update);
+	editingCamera->GetGameEntity()->PropagateEvent<EntityEventType::Update>();
 }
 
 void AssetManager::ScanProjectAssetsAndImport(std::string assetsPath, std::function<void(std::string)> progressListener) {
@@ -2383,6 +2463,7 @@ std::shared_ptr<HeightMap> AssetManager::CreateHeightMap(std::string heightmapPa
 														 bool isProjectAsset,
 														 bool isFullPathToAsset)
 {
+	MemoryScope memoryScope(MEMORY_HEIGHTMAPS);
 	std::shared_ptr<HeightMap> newHeightmap;
 	std::string fullPath;
 
@@ -2571,6 +2652,7 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> AssetManager::CreateCubemap(
 	const wchar_t* front,
 	const wchar_t* back)
 {
+	MemoryScope memoryScope(MEMORY_TEXTURES);
 #if defined(DEBUG) || defined(_DEBUG)
 	wprintf(L"Cubemap creation - Loading the following six texture paths:\n%s\n%s\n%s\n%s\n%s\n%s\n", right, left, up, down, front, back);
 #endif
@@ -2689,6 +2771,7 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> AssetManager::CreateCubemap(
 /// <returns>An SRV for the loaded textures</returns>
 Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> AssetManager::LoadParticleTexture(std::string textureNameToLoad, bool isMultiParticle, bool isProjectAsset, bool isFullPathToAsset)
 {
+	MemoryScope memoryScope(MEMORY_TEXTURES);
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> particleTextureSRV;
 	HRESULT hr;
 
@@ -2913,6 +2996,7 @@ void AssetManager::CleanAllEntities()
 		ge->Release();
 	}
 	globalEntities.clear();
+	entityIndex.Invalidate();
 }
 
 void AssetManager::CleanAllVectors() {
@@ -2936,6 +3020,7 @@ void AssetManager::CleanAllVectors() {
 	globalTerrainMaterials.clear();
 	globalSounds.clear();
 	globalFonts.clear();
+	InvalidateNameIndices();
 	textureSampleStates.clear();
 	textureState = nullptr;
 	clampState = nullptr;
@@ -2947,49 +3032,98 @@ void AssetManager::RemoveGameEntity(std::string name) {
 	RemoveGameEntity(GetGameEntityIDByName(name));
 }
 
+/// <summary>
+/// Releases and removes an entity, or records that for the EntityCommandBuffer's
+/// next sync point if component pools are being iterated
+/// </summary>
 void AssetManager::RemoveGameEntity(int id) {
+	if (EntityCommandBuffer::IsIterating()) {
+		EntityCommandBuffer::GetInstance().DestroyEntity(globalEntities[id]);
+		return;
+	}
+
 	globalEntities[id]->Release();
 	globalEntities.erase(globalEntities.begin() + id);
+	entityIndex.Invalidate();
+}
+
+/// <summary>
+/// Releases and removes many entities with a single pass over the entity list.
+/// Deferred to the EntityCommandBuffer like RemoveGameEntity while pools are being iterated.
+/// </summary>
+/// <param name="entities">Entities to remove. Duplicates, and entities already removed, are ignored</param>
+void AssetManager::RemoveGameEntities(const std::vector<std::shared_ptr<GameEntity>>& entities) {
+	if (EntityCommandBuffer::IsIterating()) {
+		for (const std::shared_ptr<GameEntity>& entity : entities) {
+			EntityCommandBuffer::GetInstance().DestroyEntity(entity);
+		}
+		return;
+	}
+
+	std::unordered_set<GameEntity*> removing;
+	for (const std::shared_ptr<GameEntity>& entity : entities) {
+		if (entity != nullptr) removing.insert(entity.get());
+	}
+
+	// Only entities still in the list are released, since a destroy recorded in an
+	// earlier batch or followed by an immediate removal may have released them already
+	std::vector<std::shared_ptr<GameEntity>> releasing;
+	for (const std::shared_ptr<GameEntity>& entity : globalEntities) {
+		if (removing.count(entity.get()) > 0) releasing.push_back(entity);
+	}
+	for (const std::shared_ptr<GameEntity>& entity : releasing) {
+		entity->Release();
+	}
+
+	globalEntities.erase(std::remove_if(globalEntities.begin(), globalEntities.end(),
+		[&removing](const std::shared_ptr<GameEntity>& entity) { return removing.count(entity.get()) > 0; }),
+		globalEntities.end());
+	entityIndex.Invalidate();
 }
 
 void AssetManager::RemoveSky(std::string name) {
-	skies.erase(skies.begin() + GetSkyIDByName(name));
+	RemoveSky(GetSkyIDByName(name));
 }
 
 void AssetManager::RemoveSky(int id) {
 	skies.erase(skies.begin() + id);
+	skyIndex.Invalidate();
 }
 
 void AssetManager::RemoveVertexShader(std::string name) {
-	vertexShaders.erase(vertexShaders.begin() + GetVertexShaderIDByName(name));
+	RemoveVertexShader(GetVertexShaderIDByName(name));
 }
 
 void AssetManager::RemoveVertexShader(int id) {
 	vertexShaders.erase(vertexShaders.begin() + id);
+	vertexShaderIndex.Invalidate();
 }
 
 void AssetManager::RemovePixelShader(std::string name) {
-	pixelShaders.erase(pixelShaders.begin() + GetPixelShaderIDByName(name));
+	RemovePixelShader(GetPixelShaderIDByName(name));
 }
 
 void AssetManager::RemovePixelShader(int id) {
 	pixelShaders.erase(pixelShaders.begin() + id);
+	pixelShaderIndex.Invalidate();
 }
 
 void AssetManager::RemoveMesh(std::string name) {
-	globalMeshes.erase(globalMeshes.begin() + GetMeshIDByName(name));
+	RemoveMesh(GetMeshIDByName(name));
 }
 
 void AssetManager::RemoveMesh(int id) {
 	globalMeshes.erase(globalMeshes.begin() + id);
+	meshIndex.Invalidate();
 }
 
 void AssetManager::RemoveMaterial(std::string name) {
-	globalMaterials.erase(globalMaterials.begin() + GetMaterialIDByName(name));
+	RemoveMaterial(GetMaterialIDByName(name));
 }
 
 void AssetManager::RemoveMaterial(int id) {
 	globalMaterials.erase(globalMaterials.begin() + id);
+	materialIndex.Invalidate();
 }
 /*
 void AssetManager::RemoveTerrainMaterial(std::string name) {
@@ -3000,6 +3134,22 @@ void AssetManager::RemoveTerrainMaterial(int id) {
 	globalEntities.erase(globalEntities.begin() + id);
 }
 */
+
+/// <summary>
+/// Forces every name index to rebuild on its next lookup
+/// </summary>
+void AssetManager::InvalidateNameIndices() {
+	pixelShaderIndex.Invalidate();
+	vertexShaderIndex.Invalidate();
+	computeShaderIndex.Invalidate();
+	skyIndex.Invalidate();
+	meshIndex.Invalidate();
+	textureIndex.Invalidate();
+	materialIndex.Invalidate();
+	entityIndex.Invalidate();
+	terrainMaterialIndex.Invalidate();
+	fontIndex.Invalidate();
+}
 #pragma endregion
 
 #pragma region nameSearch
@@ -3008,98 +3158,58 @@ void AssetManager::RemoveTerrainMaterial(int id) {
 // Asset Search-By-Name methods
 //
 
-std::shared_ptr<GameEntity> AssetManager::GetGameEntityByName(std::string name) {
-	for (int i = 0; i < globalEntities.size(); i++) {
-		if (globalEntities[i]->GetName() == name) {
-			return globalEntities[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<GameEntity> AssetManager::GetGameEntityByName(std::string_view name) {
+	int id = entityIndex.Find(name);
+	return id == -1 ? nullptr : globalEntities[id];
 }
 
-std::shared_ptr<Sky> AssetManager::GetSkyByName(std::string name) {
-	for (int i = 0; i < skies.size(); i++) {
-		if (skies[i]->GetName() == name) {
-			return skies[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<Sky> AssetManager::GetSkyByName(std::string_view name) {
+	int id = skyIndex.Find(name);
+	return id == -1 ? nullptr : skies[id];
 }
 
-std::shared_ptr<SimpleVertexShader> AssetManager::GetVertexShaderByName(std::string name) {
-	for (int i = 0; i < vertexShaders.size(); i++) {
-		if (vertexShaders[i]->GetName() == name) {
-			return vertexShaders[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<SimpleVertexShader> AssetManager::GetVertexShaderByName(std::string_view name) {
+	int id = vertexShaderIndex.Find(name);
+	return id == -1 ? nullptr : vertexShaders[id];
 }
 
-std::shared_ptr<SimplePixelShader> AssetManager::GetPixelShaderByName(std::string name) {
-	for (int i = 0; i < pixelShaders.size(); i++) {
-		if (pixelShaders[i]->GetName() == name) {
-			return pixelShaders[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<SimplePixelShader> AssetManager::GetPixelShaderByName(std::string_view name) {
+	int id = pixelShaderIndex.Find(name);
+	return id == -1 ? nullptr : pixelShaders[id];
 }
 
-std::shared_ptr<SimpleComputeShader> AssetManager::GetComputeShaderByName(std::string name) {
-	for (int i = 0; i < computeShaders.size(); i++) {
-		if (computeShaders[i]->GetName() == name) {
-			return computeShaders[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<SimpleComputeShader> AssetManager::GetComputeShaderByName(std::string_view name) {
+	int id = computeShaderIndex.Find(name);
+	return id == -1 ? nullptr : computeShaders[id];
 }
 
-std::shared_ptr<Mesh> AssetManager::GetMeshByName(std::string name) {
-	for (int i = 0; i < globalMeshes.size(); i++) {
-		if (globalMeshes[i]->GetName() == name) {
-			return globalMeshes[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<Mesh> AssetManager::GetMeshByName(std::string_view name) {
+	int id = meshIndex.Find(name);
+	return id == -1 ? nullptr : globalMeshes[id];
 }
 
-std::shared_ptr<Texture> AssetManager::GetTextureByName(std::string name) {
-	for (int i = 0; i < globalTextures.size(); i++) {
-		if (globalTextures[i]->GetName() == name) {
-			return globalTextures[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<Texture> AssetManager::GetTextureByName(std::string_view name) {
+	int id = textureIndex.Find(name);
+	return id == -1 ? nullptr : globalTextures[id];
 }
 
-std::shared_ptr<Material> AssetManager::GetMaterialByName(std::string name) {
-	for (int i = 0; i < globalMaterials.size(); i++) {
-		if (globalMaterials[i]->GetName() == name) {
-			return globalMaterials[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<Material> AssetManager::GetMaterialByName(std::string_view name) {
+	int id = materialIndex.Find(name);
+	return id == -1 ? nullptr : globalMaterials[id];
 }
 
-std::shared_ptr<TerrainMaterial> AssetManager::GetTerrainMaterialByName(std::string name) {
-	for (int i = 0; i < globalTerrainMaterials.size(); i++) {
-		if (globalTerrainMaterials[i]->GetName() == name) {
-			return globalTerrainMaterials[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<TerrainMaterial> AssetManager::GetTerrainMaterialByName(std::string_view name) {
+	int id = terrainMaterialIndex.Find(name);
+	return id == -1 ? nullptr : globalTerrainMaterials[id];
 }
 
 //
 // Dict return by key
 //
 
-std::shared_ptr<SHOEFont> AssetManager::GetFontByName(std::string name) {
-	for (int i = 0; i < globalFonts.size(); i++) {
-		if (globalFonts[i]->name == name) {
-			return globalFonts[i];
-		}
-	}
-	return nullptr;
+std::shared_ptr<SHOEFont> AssetManager::GetFontByName(std::string_view name) {
+	int id = fontIndex.Find(name);
+	return id == -1 ? nullptr : globalFonts[id];
 }
 #pragma endregion
 
@@ -3109,58 +3219,32 @@ std::shared_ptr<SHOEFont> AssetManager::GetFontByName(std::string name) {
 // These methods return the location of the entity in the vector
 //
 
-int AssetManager::GetGameEntityIDByName(std::string name) {
-	for (int i = 0; i < globalEntities.size(); i++) {
-		if (globalEntities[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetGameEntityIDByName(std::string_view name) {
+	return entityIndex.Find(name);
 }
 
-int AssetManager::GetSkyIDByName(std::string name) {
-	for (int i = 0; i < skies.size(); i++) {
-		if (skies[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetSkyIDByName(std::string_view name) {
+	return skyIndex.Find(name);
 }
 
-int AssetManager::GetVertexShaderIDByName(std::string name) {
-	for (int i = 0; i < vertexShaders.size(); i++) {
-		if (vertexShaders[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetVertexShaderIDByName(std::string_view name) {
+	return vertexShaderIndex.Find(name);
 }
 
-int AssetManager::GetPixelShaderIDByName(std::string name) {
-	for (int i = 0; i < pixelShaders.size(); i++) {
-		if (pixelShaders[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetPixelShaderIDByName(std::string_view name) {
+	return pixelShaderIndex.Find(name);
 }
 
-int AssetManager::GetMeshIDByName(std::string name) {
-	for (int i = 0; i < globalMeshes.size(); i++) {
-		if (globalMeshes[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetComputeShaderIDByName(std::string_view name) {
+	return computeShaderIndex.Find(name);
 }
 
-int AssetManager::GetMaterialIDByName(std::string name) {
-	for (int i = 0; i < globalMaterials.size(); i++) {
-		if (globalMaterials[i]->GetName() == name) {
-			return i;
-		}
-	}
-	return -1;
+int AssetManager::GetMeshIDByName(std::string_view name) {
+	return meshIndex.Find(name);
+}
+
+int AssetManager::GetMaterialIDByName(std::string_view name) {
+	return materialIndex.Find(name);
 }
 
 int AssetManager::GetPixelShaderIDByPointer(std::shared_ptr<SimplePixelShader> pixelPointer) {
@@ -1,5 +1,6 @@
 #include "../Headers/AudioHandler.h"
 #include "../Headers/AssetManager.h"
+#include "../Headers/DeferredEventBus.h"
 
 using namespace FMOD;
 
@@ -104,7 +105,7 @@ Channel* AudioHandler::LoadSoundAndInitChannel(std::string soundPath, FMOD_MODE
 //
 //	FMODUserData* uData;
 //	FMOD_RESULT uDataResult = sound->getUserData((void**)&uData);
-//	AssetManager::GetInstance().BroadcastGlobalEntityEvent(EntityEventType::OnAudioPlay, std::make_shared<AudioEventPacket>(*uData->name, channel, nullptr));
+//	AssetManager::GetInstance().BroadcastGlobalEntityEvent(EntityEventType::OnAudioPlay, AudioEventPacket(*uData->name, channel, nullptr));
 //
 //	return channel;
 //}
@@ -126,7 +127,7 @@ Channel* AudioHandler::BasicPlaySound(FMOD::Channel* channel, bool isPaused) {
 
 	FMODUserData* uData;
 	FMOD_RESULT uDataResult = currentSound->getUserData((void**)&uData);
-	AssetManager::GetInstance().BroadcastGlobalEntityEvent(eType, std::make_shared<AudioEventPacket>(*uData->name, channel, nullptr));
+	AssetManager::GetInstance().BroadcastGlobalEntityEvent(eType, AudioEventPacket(*uData->name, channel, nullptr));
 
 	return channel;
 }
@@ -189,5 +190,9 @@ FMOD_RESULT F_CALLBACK ComponentSignalCallback(FMOD_CHANNELCONTROL* channelContr
 
 	FMODUserData* uData;
 	FMOD_RESULT uDataResult = currentSound->getUserData((void**)&uData);
-	AssetManager::GetInstance().BroadcastGlobalEntityEvent(eType, std::make_shared<AudioEventPacket>(*uData->name, channel, nullptr));
+
+	// FMOD may call this off the main thread, so the scene hears about it at the next flush
+	DeferredEventBus::GetInstance().Post(eType, AudioEventPacket(*uData->name, channel, nullptr));
+
+	return FMOD_OK;
 }
\ No newline at end of file
@@ -63,22 +63,18 @@ void Collider::OnTriggerExit(std::shared_ptr<GameEntity> other)
 #endif
 }
 
-void Collider::OnTransform()
-{
-    offset->MarkMatricesDirty();
-    RegenerateBoundingBox();
-}
+#pragma region Getters/Setters
 
-void Collider::OnParentTransform(std::shared_ptr<GameEntity> parent)
+/// <summary>
+/// Rebuilt here if the offset has moved since, whether by itself or with the entity,
+/// so colliders don't need to handle transform events
+/// </summary>
+BoundingOrientedBox Collider::GetOrientedBoundingBox()
 {
-    offset->MarkMatricesDirty();
-    RegenerateBoundingBox();
+    if (offset->WorldChangedSince(obbVersion)) RegenerateBoundingBox();
+    return obb_;
 }
 
-#pragma region Getters/Setters
-
-BoundingOrientedBox Collider::GetOrientedBoundingBox() { return obb_; }
-
 DirectX::XMFLOAT3 Collider::GetPositionOffset()
 {
     return offset->GetLocalPosition();
@@ -133,6 +129,7 @@ void Collider::SetVisible(bool _isVisible) { isVisible_ = _isVisible; }
 
 void Collider::RegenerateBoundingBox()
 {
+    obbVersion = offset->GetWorldVersion();
     obb_.Center = offset->GetGlobalPosition();
     // Remember Extents are a radius but a scale is like a diameter
     XMFLOAT3 halfWidth = offset->GetGlobalScale();
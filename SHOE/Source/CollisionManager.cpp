@@ -1,19 +1,48 @@
 ﻿#include "..\Headers\CollisionManager.h"
 
+#include <algorithm>
 #include "../Headers/GameEntity.h"
 #include "..\Headers\ComponentManager.h"
+#include "..\Headers\EntityCommandBuffer.h"
 
 using namespace DirectX;
 
 // Singleton requirement
 CollisionManager* CollisionManager::instance;
 
+namespace {
+	float AxisValue(const XMFLOAT3& value, int axis)
+	{
+		return axis == 0 ? value.x : (axis == 1 ? value.y : value.z);
+	}
+
+	bool SweepOrder(const SweepEntry& a, const SweepEntry& b)
+	{
+		return a.min < b.min;
+	}
+
+	// Whether both colliders still exist, as a destroyed one has no entity to tell or name.
+	// Freeing clears a collider's handle and reusing its slot gives it a new one.
+	bool IsLive(const Collision& collision)
+	{
+		return collision.a->GetHandle() == collision.aHandle && collision.b->GetHandle() == collision.bHandle;
+	}
+}
+
 CollisionManager::CollisionManager()
 {
 	activeCollisions = std::vector<Collision>();
 	activeTriggers = std::vector<Collision>();
 	lastFrameCollisions = std::vector<Collision>();
 	lastFrameTriggers = std::vector<Collision>();
+
+	sweepEntries = std::vector<SweepEntry>();
+	sweepAxis = 0;
+	sweepMins = std::vector<XMFLOAT3>();
+	sweepMaxs = std::vector<XMFLOAT3>();
+	sweepPresent = std::vector<uint8_t>();
+	sweepHandles = std::vector<ComponentHandle>();
+	candidatePairs = std::vector<uint64_t>();
 }
 
 CollisionManager::~CollisionManager()
@@ -22,46 +51,65 @@ CollisionManager::~CollisionManager()
 	activeTriggers.clear();
 	lastFrameCollisions.clear();
 	lastFrameTriggers.clear();
+	sweepEntries.clear();
+	sweepMins.clear();
+	sweepMaxs.clear();
+	sweepPresent.clear();
+	sweepHandles.clear();
+	candidatePairs.clear();
 }
 
+/// <summary>
+/// Tests every pair of enabled colliders that could be touching, and sends enter,
+/// stay and exit events. Pairs are visited in the same order as testing every
+/// pair would, so events go out in the same order too.
+/// </summary>
 void CollisionManager::Update()
 {
-	std::vector<std::shared_ptr<Collider>> c = ComponentManager::GetAll<Collider>();
+	ComponentView<Collider> c = ComponentManager::ViewEnabled<Collider>();
 
 	if (c.size() == 0) return;
 
-	for (int i = 0; i < c.size() - 1; i++)
+	// Handlers destroying colliders mid-pass would reorder the view
+	EntityCommandBuffer::IterationScope iterating;
+	FindCandidatePairs(c);
+
+	for (uint64_t pair : candidatePairs)
 	{
-		if (!c[i]->IsEnabled()) continue;
-		std::shared_ptr<Collider> a = c[i];
-		for (int j = i + 1; j < c.size(); j++)
-		{
-			if (!c[j]->IsEnabled() || (c[i]->IsTrigger() && c[j]->IsTrigger())) continue;
-			std::shared_ptr<Collider> b = c[j];
-	
-			if (a->GetOrientedBoundingBox().Intersects(b->GetOrientedBoundingBox())) {
-				//Collision
-				if (!a->IsTrigger() && !b->IsTrigger())
-				{
-					RegisterColliderCollision(a, b);
-				}
-				//Triggers
-				else 
-				{
-					RegisterTriggerCollision(a, b);
-				}
+		uint32_t i = (uint32_t)(pair >> 32);
+		uint32_t j = (uint32_t)pair;
+
+		// Event handlers earlier in the frame may have disabled or destroyed either,
+		// so they're looked up by the handles taken before any events went out
+		Collider* a = ComponentManager::Get<Collider>(sweepHandles[i]);
+		Collider* b = ComponentManager::Get<Collider>(sweepHandles[j]);
+		if (a == nullptr || b == nullptr || !a->IsEnabled() || !b->IsEnabled()) continue;
+		if (a->IsTrigger() && b->IsTrigger()) continue;
+
+		if (a->GetOrientedBoundingBox().Intersects(b->GetOrientedBoundingBox())) {
+			//Collision
+			if (!a->IsTrigger() && !b->IsTrigger())
+			{
+				RegisterColliderCollision(a->shared_from_this(), b->shared_from_this());
+			}
+			//Triggers
+			else 
+			{
+				RegisterTriggerCollision(a->shared_from_this(), b->shared_from_this());
 			}
 		}
 	}
 
 	//Signals the end of previously registered collisions that weren't triggered this frame
 	for (int i = 0; i < lastFrameCollisions.size(); i++) {
-		lastFrameCollisions[i].a->GetGameEntity()->PropagateEvent(EntityEventType::OnCollisionExit, lastFrameCollisions[i].b->GetGameEntity());
-		lastFrameCollisions[i].b->GetGameEntity()->PropagateEvent(EntityEventType::OnCollisionExit, lastFrameCollisions[i].a->GetGameEntity());
+		if (!IsLive(lastFrameCollisions[i])) continue;
+		lastFrameCollisions[i].a->GetGameEntity()->PropagateEvent<EntityEventType::OnCollisionExit>(lastFrameCollisions[i].b->GetGameEntity());
+		lastFrameCollisions[i].b->GetGameEntity()->PropagateEvent<EntityEventType::OnCollisionExit>(lastFrameCollisions[i].a->GetGameEntity());
 	}
 	for (int i = 0; i < lastFrameTriggers.size(); i++) {
-		lastFrameTriggers[i].a->GetGameEntity()->PropagateEvent(EntityEventType::OnTriggerExit, lastFrameTriggers[i].b->GetGameEntity());
-		lastFrameTriggers[i].b->GetGameEntity()->PropagateEvent(EntityEventType::OnTriggerExit, lastFrameTriggers[i].a->GetGameEntity());
+		if (!IsLive(lastFrameTriggers[i])) continue;
+		lastFrameTriggers[i].a->GetGameEntity()->PropagateEvent<EntityEventType::OnTriggerExit>(lastFrameTriggers[i].b->GetGameEntity());
+		lastFrameTriggers[i].b->GetGameEntity()->PropagateEvent<EntityEventType::OnTriggerExit>(lastFrameTriggers[i].a->GetGameEntity());
 	}
 
 	lastFrameCollisions.clear();
@@ -70,38 +118,147 @@ void CollisionManager::Update()
 	lastFrameTriggers.swap(activeTriggers);
 }
 
+/// <summary>
+/// Sweep and prune broadphase. Fills candidatePairs with every pair of enabled
+/// colliders whose world AABBs overlap, sorted the way the all pairs loop visits them.
+/// </summary>
+/// <param name="colliders">Enabled colliders</param>
+void CollisionManager::FindCandidatePairs(ComponentView<Collider>& colliders)
+{
+	uint32_t count = (uint32_t)colliders.size();
+	sweepMins.resize(count);
+	sweepMaxs.resize(count);
+	sweepPresent.resize(count, 0);
+	sweepHandles.resize(count);
+
+	// World AABB of each oriented box, and how spread out their centers are on each axis
+	XMVECTOR centerSum = XMVectorZero();
+	XMVECTOR centerSquareSum = XMVectorZero();
+	float includedCount = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!colliders.Includes(i)) continue;
+		sweepHandles[i] = colliders[i].GetHandle();
+
+		BoundingOrientedBox box = colliders[i].GetOrientedBoundingBox();
+		XMMATRIX rotation = XMMatrixRotationQuaternion(XMLoadFloat4(&box.Orientation));
+		XMVECTOR extents = XMLoadFloat3(&box.Extents);
+		XMVECTOR halfSize = XMVectorAbs(rotation.r[0]) * XMVectorSplatX(extents)
+			+ XMVectorAbs(rotation.r[1]) * XMVectorSplatY(extents)
+			+ XMVectorAbs(rotation.r[2]) * XMVectorSplatZ(extents);
+		// Padded a hair so rounding can't drop a pair the box test counts as touching
+		halfSize *= 1.0001f;
+
+		XMVECTOR center = XMLoadFloat3(&box.Center);
+		XMStoreFloat3(&sweepMins[i], center - halfSize);
+		XMStoreFloat3(&sweepMaxs[i], center + halfSize);
+
+		centerSum += center;
+		centerSquareSum += center * center;
+		includedCount++;
+	}
+
+	// Sweep along the axis with the most variance, where the fewest boxes overlap
+	XMFLOAT3 spread;
+	XMStoreFloat3(&spread, centerSquareSum * includedCount - centerSum * centerSum);
+	int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+	// Drop entries for colliders that were disabled or destroyed, keeping the rest in order
+	size_t kept = 0;
+	for (size_t i = 0; i < sweepEntries.size(); i++) {
+		uint32_t collider = sweepEntries[i].collider;
+		if (collider < count && colliders.Includes(collider)) {
+			sweepEntries[kept++] = sweepEntries[i];
+		}
+		else if (collider < count) {
+			sweepPresent[collider] = 0;
+		}
+	}
+	sweepEntries.resize(kept);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (colliders.Includes(i) && !sweepPresent[i]) {
+			sweepPresent[i] = 1;
+			sweepEntries.push_back({ 0, 0, i });
+		}
+	}
+
+	for (SweepEntry& entry : sweepEntries) {
+		entry.min = AxisValue(sweepMins[entry.collider], axis);
+		entry.max = AxisValue(sweepMaxs[entry.collider], axis);
+	}
+
+	if (axis != sweepAxis) {
+		// Last frame's order is no help on a new axis
+		std::sort(sweepEntries.begin(), sweepEntries.end(), SweepOrder);
+		sweepAxis = axis;
+	}
+	else {
+		// Nearly sorted already, so each entry only moves past the ones it overtook
+		for (size_t i = 1; i < sweepEntries.size(); i++) {
+			SweepEntry entry = sweepEntries[i];
+			size_t j = i;
+			for (; j > 0 && SweepOrder(entry, sweepEntries[j - 1]); j--) {
+				sweepEntries[j] = sweepEntries[j - 1];
+			}
+			sweepEntries[j] = entry;
+		}
+	}
+
+	// Every box starting before this one ends overlaps it on the sweep axis
+	candidatePairs.clear();
+	for (size_t i = 0; i < sweepEntries.size(); i++) {
+		const SweepEntry& entry = sweepEntries[i];
+		const XMFLOAT3& min = sweepMins[entry.collider];
+		const XMFLOAT3& max = sweepMaxs[entry.collider];
+
+		for (size_t j = i + 1; j < sweepEntries.size() && sweepEntries[j].min <= entry.max; j++) {
+			uint32_t other = sweepEntries[j].collider;
+			const XMFLOAT3& otherMin = sweepMins[other];
+			const XMFLOAT3& otherMax = sweepMaxs[other];
+			if (otherMin.x > max.x || otherMax.x < min.x ||
+				otherMin.y > max.y || otherMax.y < min.y ||
+				otherMin.z > max.z || otherMax.z < min.z) continue;
+
+			uint32_t first = std::min<uint32_t>(entry.collider, other);
+			uint32_t second = std::max<uint32_t>(entry.collider, other);
+			candidatePairs.push_back(((uint64_t)first << 32) | second);
+		}
+	}
+	std::sort(candidatePairs.begin(), candidatePairs.end());
+}
+
 void CollisionManager::RegisterColliderCollision(std::shared_ptr<Collider> a, std::shared_ptr<Collider> b)
 {
-	Collision newCollision{ a, b };
+	Collision newCollision{ a, b, a->GetHandle(), b->GetHandle() };
 	auto& collisionPos = std::find(lastFrameCollisions.begin(), lastFrameCollisions.end(), newCollision);
 	//If this collision has already been logged
 	if (collisionPos != lastFrameCollisions.end()) {
-		a->GetGameEntity()->PropagateEvent(EntityEventType::InCollision, b->GetGameEntity());
-		b->GetGameEntity()->PropagateEvent(EntityEventType::InCollision, a->GetGameEntity());
+		a->GetGameEntity()->PropagateEvent<EntityEventType::InCollision>(b->GetGameEntity());
+		b->GetGameEntity()->PropagateEvent<EntityEventType::InCollision>(a->GetGameEntity());
 		lastFrameCollisions.erase(collisionPos);
 	}
 	else {
 		//It's a new collision
-		a->GetGameEntity()->PropagateEvent(EntityEventType::OnCollisionEnter, b->GetGameEntity());
-		b->GetGameEntity()->PropagateEvent(EntityEventType::OnCollisionEnter, a->GetGameEntity());
+		a->GetGameEntity()->PropagateEvent<EntityEventType::OnCollisionEnter>(b->GetGameEntity());
+		b->GetGameEntity()->PropagateEvent<EntityEventType::OnCollisionEnter>(a->GetGameEntity());
 	}
 	activeCollisions.push_back(newCollision);
 }
 
 void CollisionManager::RegisterTriggerCollision(std::shared_ptr<Collider> a, std::shared_ptr<Collider> b)
 {
-	Collision newTrigger{ a, b };
+	Collision newTrigger{ a, b, a->GetHandle(), b->GetHandle() };
 	auto& triggerPos = std::find(lastFrameTriggers.begin(), lastFrameTriggers.end(), newTrigger);
 	//If this collision has already been logged
 	if (triggerPos != lastFrameTriggers.end()) {
-		a->GetGameEntity()->PropagateEvent(EntityEventType::InTrigger, b->GetGameEntity());
-		b->GetGameEntity()->PropagateEvent(EntityEventType::InTrigger, a->GetGameEntity());
+		a->GetGameEntity()->PropagateEvent<EntityEventType::InTrigger>(b->GetGameEntity());
+		b->GetGameEntity()->PropagateEvent<EntityEventType::InTrigger>(a->GetGameEntity());
 		lastFrameTriggers.erase(triggerPos);
 	}
 	else {
 		//It's a new collision
-		a->GetGameEntity()->PropagateEvent(EntityEventType::OnTriggerEnter, b->GetGameEntity());
-		b->GetGameEntity()->PropagateEvent(EntityEventType::OnTriggerEnter, a->GetGameEntity());
+		a->GetGameEntity()->PropagateEvent<EntityEventType::OnTriggerEnter>(b->GetGameEntity());
+		b->GetGameEntity()->PropagateEvent<EntityEventType::OnTriggerEnter>(a->GetGameEntity());
 	}
 	activeTriggers.push_back(newTrigger);
 }
@@ -0,0 +1,25 @@
+#include "..\Headers\ComponentTicks.h"
+
+#include "..\Headers\SystemScheduler.h"
+#include "..\Headers\EntityCommandBuffer.h"
+
+std::vector<ComponentTicks::TickList> ComponentTicks::tickLists = std::vector<ComponentTicks::TickList>();
+
+/// <summary>
+/// Ticks every enabled component whose type overrides this phase's hook,
+/// one type at a time in pool order. Types run by the SystemScheduler are left to it.
+/// </summary>
+/// <param name="phase">Update or EditingUpdate</param>
+void ComponentTicks::Run(EntityEventType phase)
+{
+	ComponentMask scheduledTypes = SystemScheduler::GetInstance().GetScheduledTypes(phase);
+	EntityCommandBuffer::IterationScope iterating;
+
+	for (size_t i = 0; i < tickLists.size(); i++) {
+		TickList& list = tickLists[i];
+		if (!(phase == EntityEventType::Update ? list.update : list.editingUpdate)) continue;
+		if (scheduledTypes & ((ComponentMask)1 << list.type)) continue;
+
+		list.tick(phase);
+	}
+}
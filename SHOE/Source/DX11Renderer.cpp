@@ -1,4 +1,6 @@
 #include "../Headers/DX11Renderer.h"
+#include "../Headers/RenderSnapshot.h"
+#include "../Headers/Time.h"
 
 using namespace DirectX;
 
@@ -358,6 +360,7 @@ void DX11Renderer::InitRenderTargetViews() {
 
 void DX11Renderer::InitShadows() {
 	shadowCount = 0;
+	drawSnapshot = nullptr;
 	shadowRasterizer.Reset();
 	shadowSampler.Reset();
 	this->VSShadow.reset();
@@ -470,25 +473,14 @@ void DX11Renderer::DrawPointLights(std::shared_ptr<Camera> cam)
 	context->IASetVertexBuffers(0, 1, sphereMesh->GetVertexBuffer().GetAddressOf(), &stride, &offset);
 	context->IASetIndexBuffer(sphereMesh->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
 
-	for (std::shared_ptr<Light> light : ComponentManager::GetAll<Light>())
+	const RenderSnapshot& snapshot = *drawSnapshot;
+	for (const RenderSnapshotPointLight& light : snapshot.pointLights)
 	{
-		// Only drawing points, so skip others
-		if (light->GetType() != 1.0f || !light->IsEnabled())
-			continue;
-
-		// Calc quick scale based on range
-		// (assuming range is between 5 - 10)
-		float scale = light->GetRange() / 10.0f;
-
 		// Set up the world matrix for this light
-		basicVS->SetMatrix4x4("world", light->GetTransform()->GetWorldMatrix());
+		basicVS->SetMatrix4x4("world", light.world);
 
 		// Set up the pixel shader data
-		DirectX::XMFLOAT3 finalColor = light->GetColor();
-		finalColor.x *= light->GetIntensity();
-		finalColor.y *= light->GetIntensity();
-		finalColor.z *= light->GetIntensity();
-		solidColorPS->SetFloat3("Color", finalColor);
+		solidColorPS->SetFloat3("Color", light.color);
 
 		// Copy data
 		basicVS->CopyAllBufferData();
@@ -502,6 +494,8 @@ void DX11Renderer::DrawPointLights(std::shared_ptr<Camera> cam)
 }
 
 void DX11Renderer::RenderDepths(std::shared_ptr<Camera> sourceCam, MiscEffectSRVTypes type) {
+	const RenderSnapshot& snapshot = *drawSnapshot;
+
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> miscEffectDepth;
 	miscEffectDepth = miscEffectDepthBuffers[type];
 
@@ -528,11 +522,12 @@ void DX11Renderer::RenderDepths(std::shared_ptr<Camera> sourceCam, MiscEffectSRV
 
 		context->OMSetDepthStencilState(refractionSilhouetteDepthState.Get(), 0);
 
-		for (std::shared_ptr<MeshRenderer> mesh : ComponentManager::GetAll<MeshRenderer>()) {
-			if (!mesh->IsEnabled() || !mesh->GetMaterial()->GetTransparent()) continue;
+		// Transparent draws come after the opaque ones
+		for (size_t i = snapshot.opaqueCount; i < snapshot.items.size(); i++) {
+			const RenderSnapshotItem& item = snapshot.items[i];
 
 			// Standard depth pre-pass
-			VSShadow->SetMatrix4x4("world", mesh->GetTransform()->GetWorldMatrix());
+			VSShadow->SetMatrix4x4("world", item.world);
 
 			VSShadow->CopyAllBufferData();
 
@@ -540,11 +535,12 @@ void DX11Renderer::RenderDepths(std::shared_ptr<Camera> sourceCam, MiscEffectSRV
 			solidColorPS->SetFloat3("Color", DirectX::XMFLOAT3(1, 1, 1));
 			solidColorPS->CopyAllBufferData();
 
-			context->IASetVertexBuffers(0, 1, mesh->GetMesh()->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			context->IASetIndexBuffer(mesh->GetMesh()->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+			const RenderSnapshotMesh& mesh = snapshot.meshes[item.mesh];
+			context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 			context->DrawIndexed(
-				mesh->GetMesh()->GetIndexCount(),
+				mesh.indexCount,
 				0,
 				0);
 		}
@@ -556,21 +552,23 @@ void DX11Renderer::RenderDepths(std::shared_ptr<Camera> sourceCam, MiscEffectSRV
 	{
 		context->OMSetRenderTargets(1, renderTargetRTVs[RTVTypes::DEPTHS].GetAddressOf(), depthBufferDSV.Get());
 
-		for (std::shared_ptr<MeshRenderer> mesh : ComponentManager::GetAll<MeshRenderer>()) {
-			if (!mesh->IsEnabled() || !mesh->GetMaterial()->GetTransparent()) continue;
+		// Transparent draws come after the opaque ones
+		for (size_t i = snapshot.opaqueCount; i < snapshot.items.size(); i++) {
+			const RenderSnapshotItem& item = snapshot.items[i];
 
 			// Standard depth pre-pass
-			VSShadow->SetMatrix4x4("world", mesh->GetTransform()->GetWorldMatrix());
+			VSShadow->SetMatrix4x4("world", item.world);
 
 			solidColorPS->SetShader();
 			solidColorPS->SetFloat3("Color", DirectX::XMFLOAT3(1, 1, 1));
 			solidColorPS->CopyAllBufferData();
 
-			context->IASetVertexBuffers(0, 1, mesh->GetMesh()->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			context->IASetIndexBuffer(mesh->GetMesh()->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+			const RenderSnapshotMesh& mesh = snapshot.meshes[item.mesh];
+			context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 			context->DrawIndexed(
-				mesh->GetMesh()->GetIndexCount(),
+				mesh.indexCount,
 				0,
 				0);
 		}
@@ -596,6 +594,8 @@ void DX11Renderer::RenderDepths(std::shared_ptr<Camera> sourceCam, MiscEffectSRV
 /// Renders out the shadow maps for all active shadow projectors
 /// </summary>
 void DX11Renderer::RenderShadows() {
+	const RenderSnapshot& snapshot = *drawSnapshot;
+
 	shadowDSVArray.clear();
 	shadowProjMatArray.clear();
 	shadowViewMatArray.clear();
@@ -608,45 +608,42 @@ void DX11Renderer::RenderShadows() {
 
 	int newShadowCount = 0;
 	//Renders each shadow map
-	for (std::shared_ptr<Light> light : ComponentManager::GetAll<Light>()) {
-		if (!light->IsEnabled() || !light->CastsShadows()) continue;
-
-		std::shared_ptr<ShadowProjector> projector = light->GetShadowProjector();
-
-		context->OMSetRenderTargets(0, 0, projector->GetDSV().Get());
-		context->ClearDepthStencilView(projector->GetDSV().Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+	for (const RenderSnapshotShadow& shadow : snapshot.shadows) {
+		context->OMSetRenderTargets(0, 0, shadow.depthStencil.Get());
+		context->ClearDepthStencilView(shadow.depthStencil.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 		context->RSSetState(shadowRasterizer.Get());
 
-		vp.Width = (float)projector->GetProjectionWidth();
-		vp.Height = (float)projector->GetProjectionHeight();
+		vp.Width = (float)shadow.width;
+		vp.Height = (float)shadow.height;
 		context->RSSetViewports(1, &vp);
 
 		VSShadow->SetShader();
-		VSShadow->SetMatrix4x4("view", projector->GetViewMatrix());
-		VSShadow->SetMatrix4x4("projection", projector->GetProjectionMatrix());
+		VSShadow->SetMatrix4x4("view", shadow.view);
+		VSShadow->SetMatrix4x4("projection", shadow.projection);
 		VSShadow->CopyBufferData("perFrame");
 		context->PSSetShader(0, 0, 0);
 
-		for (std::shared_ptr<MeshRenderer> mesh : ComponentManager::GetAll<MeshRenderer>()) {
-			//Ignores transparent meshes
-			if (!mesh->IsEnabled() || mesh->GetMaterial()->GetTransparent()) continue;
+		//Ignores transparent meshes, which come after the opaque ones
+		for (size_t i = 0; i < snapshot.opaqueCount; i++) {
+			const RenderSnapshotItem& item = snapshot.items[i];
 
 			// This is similar to what I'd need for any depth pre-pass
-			VSShadow->SetMatrix4x4("world", mesh->GetTransform()->GetWorldMatrix());
+			VSShadow->SetMatrix4x4("world", item.world);
 			VSShadow->CopyBufferData("perObject");
 
-			context->IASetVertexBuffers(0, 1, mesh->GetMesh()->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			context->IASetIndexBuffer(mesh->GetMesh()->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+			const RenderSnapshotMesh& mesh = snapshot.meshes[item.mesh];
+			context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 			context->DrawIndexed(
-				mesh->GetMesh()->GetIndexCount(),
+				mesh.indexCount,
 				0,
 				0);
 		}
 
-		shadowDSVArray.emplace_back(projector->GetDSV());
-		shadowProjMatArray.emplace_back(projector->GetProjectionMatrix());
-		shadowViewMatArray.emplace_back(projector->GetViewMatrix());
+		shadowDSVArray.emplace_back(shadow.depthStencil);
+		shadowProjMatArray.emplace_back(shadow.projection);
+		shadowViewMatArray.emplace_back(shadow.view);
 		newShadowCount++;
 	}
 
@@ -728,15 +725,15 @@ void DX11Renderer::RenderColliders(std::shared_ptr<Camera> cam)
 	context->IASetVertexBuffers(0, 1, cubeMesh->GetVertexBuffer().GetAddressOf(), &stride, &offset);
 	context->IASetIndexBuffer(cubeMesh->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
 
-	for (std::shared_ptr<Collider> collider : ComponentManager::GetAll<Collider>())
+	for (Collider& collider : ComponentManager::ViewEnabled<Collider>())
 	{
-		if (collider->IsEnabled() && collider->IsVisible()) {
-			basicVS->SetMatrix4x4("world", collider->GetWorldMatrix());
+		if (collider.IsVisible()) {
+			basicVS->SetMatrix4x4("world", collider.GetWorldMatrix());
 
 			// Set up the pixel shader data
 			XMFLOAT3 finalColor = XMFLOAT3(0.5f, 1.0f, 1.0f);
 			// Drawing colliders and triggerboxes as different colors
-			if (collider->IsTrigger())
+			if (collider.IsTrigger())
 			{
 				finalColor = XMFLOAT3(1.0f, 1.0f, 0.0f);
 			}
@@ -774,11 +771,11 @@ void DX11Renderer::RenderMeshBounds(std::shared_ptr<Camera> cam)
 	context->IASetVertexBuffers(0, 1, cubeMesh->GetVertexBuffer().GetAddressOf(), &stride, &offset);
 	context->IASetIndexBuffer(cubeMesh->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
 
-	for (std::shared_ptr<MeshRenderer> mesh : ComponentManager::GetAll<MeshRenderer>())
+	for (MeshRenderer& mesh : ComponentManager::ViewEnabled<MeshRenderer>())
 	{
-		if (mesh->IsEnabled() && mesh->DrawBounds) {
+		if (mesh.DrawBounds) {
 			//Make the world matrix for this bounds box
-			BoundingOrientedBox obb = mesh->GetBounds();
+			BoundingOrientedBox obb = mesh.GetBounds();
 			XMMATRIX transMat = XMMatrixTranslation(obb.Center.x, obb.Center.y, obb.Center.z);
 			XMMATRIX scaleMat = XMMatrixScaling(obb.Extents.x * 2, obb.Extents.y * 2, obb.Extents.z * 2);
 			XMMATRIX rotMat = XMMatrixRotationQuaternion(XMLoadFloat4(&obb.Orientation));
@@ -887,6 +884,11 @@ void DX11Renderer::RenderSelectedHighlight(std::shared_ptr<Camera> cam, EngineSt
 }
 
 void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
+	// The scene as of the end of the last simulated frame, see RenderQueue::Capture,
+	// blended toward the frame before when drawing behind the simulation
+	RenderSnapshotBuffer& snapshots = RenderSnapshotBuffer::GetInstance();
+	drawSnapshot = &snapshots.GetInterpolated(snapshots.GetAlpha(Time::totalTime - snapshots.GetInterpolationDelay()));
+
 	RenderShadows();
 
 	// Background color (Cornflower Blue in this case) for clearing
@@ -923,11 +925,13 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 	 //context->OMSetDepthStencilState(prePassDepthState.Get(), 0);
 
+	const RenderSnapshot& snapshot = *drawSnapshot;
+
 	// Per Frame data can be set out here for optimization
 	// This section could be improved, see Chris's Demos and
 	// Structs in header. Currently only supports the single default 
 	// PBR+IBL shader
-	unsigned int lightCount = Light::GetLightArrayCount();
+	unsigned int lightCount = snapshot.lightCount;
 
 	perFrameVS->SetMatrix4x4("view", cam->GetViewMatrix());
 	perFrameVS->SetMatrix4x4("projection", cam->GetProjectionMatrix());
@@ -937,7 +941,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 	}
 	perFrameVS->SetInt("shadowCount", shadowCount);
 
-	perFramePS->SetData("lights", Light::GetLightArray(), sizeof(LightData) * MAX_LIGHTS);
+	perFramePS->SetData("lights", snapshot.lights, sizeof(LightData) * MAX_LIGHTS);
 	perFramePS->SetData("lightCount", &lightCount, sizeof(unsigned int));
 	perFramePS->SetFloat3("cameraPos", cam->GetTransform()->GetLocalPosition());
 	if (globalAssets.currentSky->IsEnabled()) {
@@ -950,25 +954,21 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 	// Material-Sort Rendering:
 	// To potentially save operations, track a current Material and Mesh
-	// A note that this list is NOT sorted by mesh - current Mesh
-	// is tracked on the chance of saving a cycle if two+ concurrent
-	// Meshes are the same.
-	// VS and PS are tracked for materials that differ, but share
-	// shaders with other objects.
+	// The render queue orders draws by transparency, then vertex and
+	// pixel shader, then material, then mesh, so each of these only
+	// changes when the next group in the sorted list starts.
 
 	SimpleVertexShader* currentVS = 0;
 	SimplePixelShader* currentPS = 0;
-	DX11Material* currentMaterial = 0;
-	Mesh* currentMesh = 0;
-
-	std::vector<std::shared_ptr<MeshRenderer>> activeMeshes = ComponentManager::GetAll<MeshRenderer>();
+	uint32_t currentMaterial = UINT32_MAX;
+	uint32_t currentMesh = UINT32_MAX;
 
-	for (meshIt = 0; meshIt < activeMeshes.size() && !activeMeshes[meshIt]->GetMaterial()->GetTransparent(); meshIt++)
+	for (meshIt = 0; meshIt < snapshot.opaqueCount; meshIt++)
 	{
-		if (!activeMeshes[meshIt]->IsEnabled()) continue;
+		const RenderSnapshotItem& item = snapshot.items[meshIt];
 
 		//If the material needs to be swapped
-		if (activeMeshes[meshIt]->GetMaterial().get() != currentMaterial)
+		if (item.material != currentMaterial)
 		{
 			// Eventual improvement:
 			// Move all VS and PS "Set" calls into Material
@@ -976,46 +976,47 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 			// With shadows, it would also require passing in a lot of data
 			// And handling edge cases like main camera swaps
 
-			currentMaterial = dynamic_cast<DX11Material*>(activeMeshes[meshIt]->GetMaterial().get());
+			currentMaterial = item.material;
+			const RenderSnapshotMaterial& material = snapshot.materials[currentMaterial];
 
-			if (currentVS != currentMaterial->GetVertShader().get()) {
+			if (currentVS != material.vertexShader.get()) {
 				// Set new Shader and copy per-frame data
-				currentVS = currentMaterial->GetVertShader().get();
+				currentVS = material.vertexShader.get();
 				currentVS->SetShader();
 
 				perFrameVS->CopyBufferData("PerFrame");
 			}
 
-			if (currentPS != currentMaterial->GetPixShader().get()) {
+			if (currentPS != material.pixelShader.get()) {
 				// Set new Shader and copy per-frame data
-				currentPS = currentMaterial->GetPixShader().get();
+				currentPS = material.pixelShader.get();
 				currentPS->SetShader();
 
 				perFramePS->CopyBufferData("PerFrame");
 			}
 
 			// Per-Material VS Data
-			currentVS->SetFloat4("colorTint", currentMaterial->GetTint());
+			currentVS->SetFloat4("colorTint", material.tint);
 
 			currentVS->CopyBufferData("PerMaterial");
 
 			// Per-Material PS Data
-			currentPS->SetFloat("uvMult", currentMaterial->GetTiling());
+			currentPS->SetFloat("uvMult", material.tiling);
 
 			currentPS->CopyBufferData("PerMaterial");
 
 			// Set textures and samplers
-			currentPS->SetSamplerState("sampleState", currentMaterial->GetSamplerState().Get());
-			currentPS->SetSamplerState("clampSampler", currentMaterial->GetClampSamplerState().Get());
-			currentPS->SetShaderResourceView("textureAlbedo", currentMaterial->GetAlbedoMapSRV().Get());
-			if (currentMaterial->GetMetalMap() != nullptr) {
-				currentPS->SetShaderResourceView("textureMetal", currentMaterial->GetMetalMapSRV().Get());
+			currentPS->SetSamplerState("sampleState", material.sampler.Get());
+			currentPS->SetSamplerState("clampSampler", material.clampSampler.Get());
+			currentPS->SetShaderResourceView("textureAlbedo", material.albedo.Get());
+			if (material.metal != nullptr) {
+				currentPS->SetShaderResourceView("textureMetal", material.metal.Get());
 			}
-			if (currentMaterial->GetRoughMap() != nullptr) {
-				currentPS->SetShaderResourceView("textureRough", currentMaterial->GetRoughMapSRV().Get());
+			if (material.rough != nullptr) {
+				currentPS->SetShaderResourceView("textureRough", material.rough.Get());
 			}
-			if (currentMaterial->GetNormalMap() != nullptr) {
-				currentPS->SetShaderResourceView("textureNormal", currentMaterial->GetNormalMapSRV().Get());
+			if (material.normal != nullptr) {
+				currentPS->SetShaderResourceView("textureNormal", material.normal.Get());
 			}
 
 			currentPS->SetSamplerState("shadowState", shadowSampler.Get());
@@ -1030,40 +1031,33 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 			}
 		}
 
-		if (currentMesh != activeMeshes[meshIt]->GetMesh().get()) {
-			currentMesh = activeMeshes[meshIt]->GetMesh().get();
+		const RenderSnapshotMesh& mesh = snapshot.meshes[item.mesh];
+		if (currentMesh != item.mesh) {
+			currentMesh = item.mesh;
 
-			context->IASetVertexBuffers(0, 1, currentMesh->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			context->IASetIndexBuffer(currentMesh->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+			context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 		}
 
 		if (currentVS != 0) {
 			// Per-Object data
-			currentVS->SetMatrix4x4("world", activeMeshes[meshIt]->GetTransform()->GetWorldMatrix());
+			currentVS->SetMatrix4x4("world", item.world);
+			currentVS->SetMatrix4x4("worldInverseTranspose", item.worldInverseTranspose);
 
 			currentVS->CopyBufferData("PerObject");
 		}
 
-		if (currentMesh != 0) {
-			context->DrawIndexed(currentMesh->GetIndexCount(), 0, 0);
-		}
+		context->DrawIndexed(mesh.indexCount, 0, 0);
 	}
 
 
 	//Now deal with rendering the terrain, PS data first
-	std::vector<std::shared_ptr<Terrain>> terrains = ComponentManager::GetAll<Terrain>();
-	DX11Material* currentMat;
-	for (int i = 0; i < terrains.size(); i++) {
-		if (!terrains[i]->IsEnabled()) continue;
-
-		std::shared_ptr<TerrainMaterial> terrainMat = terrains[i]->GetMaterial();
-		std::shared_ptr<SimplePixelShader> PSTerrain = terrains[i]->GetMaterial()->GetPixelShader();
-		std::shared_ptr<SimpleVertexShader> VSTerrain = terrains[i]->GetMaterial()->GetVertexShader();
-		//DX11TerrainMaterial* terrainMat = dynamic_cast<DX11TerrainMaterial*>(tempTerrainMat.get());
-		currentMat = dynamic_cast<DX11Material*>(terrainMat->GetMaterialAtID(0).get());
+	for (const RenderSnapshotTerrain& terrain : snapshot.terrains) {
+		std::shared_ptr<SimplePixelShader> PSTerrain = terrain.pixelShader;
+		std::shared_ptr<SimpleVertexShader> VSTerrain = terrain.vertexShader;
 
 		PSTerrain->SetShader();
-		PSTerrain->SetData("lights", Light::GetLightArray(), sizeof(LightData) * MAX_LIGHTS);
+		PSTerrain->SetData("lights", snapshot.lights, sizeof(LightData) * MAX_LIGHTS);
 		PSTerrain->SetData("lightCount", &lightCount, sizeof(unsigned int));
 		PSTerrain->SetFloat3("cameraPos", cam->GetTransform()->GetLocalPosition());
 		PSTerrain->SetFloat("uvMultNear", 50.0f);
@@ -1072,21 +1066,21 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 			PSTerrain->SetShaderResourceView("shadowMaps", shadowDSVArraySRV.Get());
 			PSTerrain->SetSamplerState("shadowState", shadowSampler.Get());
 		}
-		PSTerrain->SetShaderResourceView("blendMap", terrainMat->GetBlendMap().Get());
-		PSTerrain->SetSamplerState("clampSampler", currentMat->GetClampSamplerState().Get());
+		PSTerrain->SetShaderResourceView("blendMap", terrain.blendMap.Get());
+		PSTerrain->SetSamplerState("clampSampler", terrain.clampSampler.Get());
 
-		for (int i = 0; i < terrainMat->GetMaterialCount(); i++) {
+		for (uint32_t i = 0; i < terrain.layerCount; i++) {
 			std::string a = "texture" + std::to_string(i + 1) + "Albedo";
 			std::string n = "texture" + std::to_string(i + 1) + "Normal";
 			std::string r = "texture" + std::to_string(i + 1) + "Rough";
 			std::string m = "texture" + std::to_string(i + 1) + "Metal";
 
-			currentMat = dynamic_cast<DX11Material*>(terrainMat->GetMaterialAtID(i).get());
+			const Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>* layer = &snapshot.terrainTextures[terrain.firstTexture + i * RenderSnapshotTerrain::TexturesPerLayer];
 
-			PSTerrain->SetShaderResourceView(a, currentMat->GetTexture()->GetDX11Texture());
-			PSTerrain->SetShaderResourceView(n, currentMat->GetNormalMap()->GetDX11Texture());
-			PSTerrain->SetShaderResourceView(r, currentMat->GetRoughMap()->GetDX11Texture());
-			PSTerrain->SetShaderResourceView(m, currentMat->GetMetalMap()->GetDX11Texture());
+			PSTerrain->SetShaderResourceView(a, layer[0]);
+			PSTerrain->SetShaderResourceView(n, layer[1]);
+			PSTerrain->SetShaderResourceView(r, layer[2]);
+			PSTerrain->SetShaderResourceView(m, layer[3]);
 		}
 
 		if (globalAssets.currentSky->IsEnabled()) {
@@ -1101,7 +1095,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 		VSTerrain->SetShader();
 
 		VSTerrain->SetFloat4("colorTint", DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
-		VSTerrain->SetMatrix4x4("world", terrains[i]->GetTransform()->GetWorldMatrix());
+		VSTerrain->SetMatrix4x4("world", terrain.world);
 		VSTerrain->SetMatrix4x4("view", cam->GetViewMatrix());
 		VSTerrain->SetMatrix4x4("projection", cam->GetProjectionMatrix());
 		if (shadowCount > 0) {
@@ -1112,11 +1106,12 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 		VSTerrain->CopyAllBufferData();
 
-		context->IASetVertexBuffers(0, 1, terrains[i]->GetMesh()->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(terrains[i]->GetMesh()->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+		const RenderSnapshotMesh& mesh = snapshot.meshes[terrain.mesh];
+		context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+		context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 		context->DrawIndexed(
-			terrains[i]->GetMesh()->GetIndexCount(),     // The number of indices to use (we could draw a subset if we wanted)
+			mesh.indexCount,     // The number of indices to use (we could draw a subset if we wanted)
 			0,     // Offset to the first index we want to use
 			0);    // Offset to add to each index when looking up vertices
 	}
@@ -1190,7 +1185,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 	// Refractive and Transparent objects are drawn here
 	// This uses refraction silhouette techniques, as well as
 	// the depth pre-pass from earlier in Draw
-	if (meshIt < activeMeshes.size())
+	if (meshIt < snapshot.items.size())
 	{
 		renderTargets[0] = renderTargetRTVs[RTVTypes::COMPOSITE].Get();
 	}
@@ -1211,6 +1206,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 	context->Draw(3, 0);
 
 	//Editing mode only debug renders
+	//Colliders and mesh bounds are read live from the scene, not the snapshot
 	if (engineState == EngineState::EDITING) {
 		context->OMSetRenderTargets(1, renderTargets, depthBufferDSV.Get());
 		if (drawColliders) RenderColliders(cam);
@@ -1218,17 +1214,17 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 		DrawPointLights(cam);
 	}
 
-	context->OMSetRenderTargets(1, renderTargets, (meshIt < activeMeshes.size()) ? depthBufferDSV.Get() : 0);
+	context->OMSetRenderTargets(1, renderTargets, (meshIt < snapshot.items.size()) ? depthBufferDSV.Get() : 0);
 
 	//Render all of the emitters
+	//Emitters simulate on the GPU as they draw, so they're read live rather than from the snapshot
 	context->OMSetDepthStencilState(particleDepthState.Get(), 0);
-	for (std::shared_ptr<ParticleSystem> emitter : ComponentManager::GetAll<ParticleSystem>())
+	for (ParticleSystem& emitter : ComponentManager::ViewEnabled<ParticleSystem>())
 	{
-		if (emitter->IsEnabled())
-			emitter->Draw(cam, particleBlendAdditive);
+		emitter.Draw(cam, particleBlendAdditive);
 	}
 
-	if (meshIt < activeMeshes.size())
+	if (meshIt < snapshot.items.size())
 	{
 		context->OMSetBlendState(0, 0, 0xFFFFFFFF);
 
@@ -1243,7 +1239,10 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 		textureSamplePS->SetShader();
 		textureSamplePS->SetShaderResourceView("Pixels", renderTargetSRVs[RTVTypes::COMPOSITE].Get());
-		textureSamplePS->SetSamplerState("BasicSampler", activeMeshes[meshIt]->GetMaterial()->GetSamplerState());
+		// Currently, all refractive materials share shaders and samplers, so the first one's will do
+		const RenderSnapshotMaterial& firstMaterial = snapshot.materials[snapshot.items[meshIt].material];
+
+		textureSamplePS->SetSamplerState("BasicSampler", firstMaterial.sampler);
 		context->Draw(3, 0);
 
 		// First, create the refraction silhouette
@@ -1253,8 +1252,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 		renderTargets[0] = renderTargetRTVs[RTVTypes::FINAL_COMPOSITE].Get();
 		context->OMSetRenderTargets(1, renderTargets, depthBufferDSV.Get());
 
-		// Currently, all refractive shaders are the same, so this is fine
-		std::shared_ptr<SimplePixelShader> refractivePS = activeMeshes[meshIt]->GetMaterial()->GetRefractivePixelShader();
+		std::shared_ptr<SimplePixelShader> refractivePS = firstMaterial.refractivePixelShader;
 		refractivePS->SetShader();
 
 		refractivePS->SetFloat2("screenSize", XMFLOAT2((float)windowWidth, (float)windowHeight));
@@ -1262,7 +1260,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 		refractivePS->SetMatrix4x4("projMatrix", cam->GetProjectionMatrix());
 		refractivePS->SetFloat3("cameraPos", cam->GetTransform()->GetLocalPosition());
 
-		refractivePS->SetData("lights", Light::GetLightArray(), sizeof(Light) * MAX_LIGHTS);
+		refractivePS->SetData("lights", snapshot.lights, sizeof(LightData) * MAX_LIGHTS);
 		refractivePS->SetData("lightCount", &lightCount, sizeof(unsigned int));
 
 		refractivePS->SetShaderResourceView("environmentMap", globalAssets.currentSky->GetSkyTexture().Get());
@@ -1272,7 +1270,7 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 		refractivePS->CopyBufferData("PerFrame");
 
-		std::shared_ptr<SimpleVertexShader> refractiveVS = activeMeshes[meshIt]->GetMaterial()->GetVertShader();
+		std::shared_ptr<SimpleVertexShader> refractiveVS = firstMaterial.vertexShader;
 
 		refractiveVS->SetShader();
 
@@ -1282,32 +1280,35 @@ void DX11Renderer::Draw(std::shared_ptr<Camera> cam, EngineState engineState) {
 
 		refractiveVS->CopyBufferData("PerFrame");
 
-		for (meshIt = meshIt; meshIt < activeMeshes.size(); meshIt++) {
-			if (!activeMeshes[meshIt]->IsEnabled()) continue;
+		for (meshIt = meshIt; meshIt < snapshot.items.size(); meshIt++) {
+			const RenderSnapshotItem& item = snapshot.items[meshIt];
+			const RenderSnapshotMaterial& material = snapshot.materials[item.material];
+			const RenderSnapshotMesh& mesh = snapshot.meshes[item.mesh];
 
-			refractiveVS->SetFloat4("colorTint", activeMeshes[meshIt]->GetMaterial()->GetTint());
+			refractiveVS->SetFloat4("colorTint", material.tint);
 
 			refractiveVS->CopyBufferData("PerMaterial");
 
-			refractiveVS->SetMatrix4x4("world", activeMeshes[meshIt]->GetTransform()->GetWorldMatrix());
+			refractiveVS->SetMatrix4x4("world", item.world);
+			refractiveVS->SetMatrix4x4("worldInverseTranspose", item.worldInverseTranspose);
 
 			refractiveVS->CopyBufferData("PerObject");
 
-			refractivePS->SetFloat("uvMult", activeMeshes[meshIt]->GetMaterial()->GetTiling());
-			refractivePS->SetFloat("indexOfRefraction", activeMeshes[meshIt]->GetMaterial()->GetIndexOfRefraction());
-			refractivePS->SetFloat("refractionScale", activeMeshes[meshIt]->GetMaterial()->GetRefractionScale());
-			refractivePS->SetFloat("isRefractive", activeMeshes[meshIt]->GetMaterial()->GetRefractive());
+			refractivePS->SetFloat("uvMult", material.tiling);
+			refractivePS->SetFloat("indexOfRefraction", material.indexOfRefraction);
+			refractivePS->SetFloat("refractionScale", material.refractionScale);
+			refractivePS->SetFloat("isRefractive", material.refractive);
 
 			refractivePS->CopyBufferData("PerMaterial");
 
-			refractivePS->SetShaderResourceView("textureNormal", activeMeshes[meshIt]->GetMaterial()->GetNormalMap()->GetDX11Texture());
-			refractivePS->SetShaderResourceView("textureRoughness", activeMeshes[meshIt]->GetMaterial()->GetRoughMap()->GetDX11Texture());
-			refractivePS->SetShaderResourceView("textureMetal", activeMeshes[meshIt]->GetMaterial()->GetMetalMap()->GetDX11Texture());
+			refractivePS->SetShaderResourceView("textureNormal", material.normal);
+			refractivePS->SetShaderResourceView("textureRoughness", material.rough);
+			refractivePS->SetShaderResourceView("textureMetal", material.metal);
 
-			context->IASetVertexBuffers(0, 1, activeMeshes[meshIt]->GetMesh()->GetVertexBuffer().GetAddressOf(), &stride, &offset);
-			context->IASetIndexBuffer(activeMeshes[meshIt]->GetMesh()->GetIndexBuffer().Get(), DXGI_FORMAT_R32_UINT, 0);
+			context->IASetVertexBuffers(0, 1, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
-			context->DrawIndexed(activeMeshes[meshIt]->GetMesh()->GetIndexCount(), 0, 0);
+			context->DrawIndexed(mesh.indexCount, 0, 0);
 		}
 	}
 
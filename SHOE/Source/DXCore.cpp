@@ -755,6 +755,7 @@ void DXCore::UpdateTimer()
 	Time::currentTime = currentTime;
 	Time::deltaTime = deltaTime;
 	Time::totalTime = totalTime;
+	Time::frameCount++;
 
 	// Save current time for next frame
 	previousTime = currentTime;
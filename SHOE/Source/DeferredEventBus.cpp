@@ -0,0 +1,171 @@
+#include "..\Headers\DeferredEventBus.h"
+
+#include "..\Headers\AssetManager.h"
+
+static_assert((DeferredEventBus::Capacity & (DeferredEventBus::Capacity - 1)) == 0, "DeferredEventBus::Capacity must be a power of two");
+
+// Singleton requirement
+DeferredEventBus* DeferredEventBus::instance;
+
+DeferredEventBus::DeferredEventBus()
+{
+	slots = std::make_unique<Slot[]>(Capacity);
+	for (size_t i = 0; i < Capacity; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	enqueuePosition.store(0, std::memory_order_relaxed);
+	dequeuePosition = 0;
+	droppedCount.store(0, std::memory_order_relaxed);
+	lastFlushCount = 0;
+
+	broadcastBatch = std::vector<EntityEventMessage>();
+}
+
+DeferredEventBus::~DeferredEventBus()
+{
+	for (std::vector<DeferredEvent>& batch : batches) {
+		batch.clear();
+	}
+	broadcastBatch.clear();
+}
+
+/// <summary>
+/// Queues an event for every entity, delivered at the next Flush.
+/// Safe to call from any thread.
+/// </summary>
+/// <param name="event">Message type to send</param>
+/// <param name="message">Body of the message, should one be needed</param>
+/// <returns>False if the message doesn't fit the event or the queue is full</returns>
+bool DeferredEventBus::Post(EntityEventType event, const EntityEventMessage& message)
+{
+	return Enqueue(event, message, std::weak_ptr<GameEntity>(), true);
+}
+
+/// <summary>
+/// Queues an event for one entity and its components, delivered at the next
+/// Flush if the entity still exists. Safe to call from any thread.
+/// </summary>
+/// <param name="target">Entity to send to</param>
+/// <param name="event">Message type to send</param>
+/// <param name="message">Body of the message, should one be needed</param>
+/// <returns>False if the message doesn't fit the event or the queue is full</returns>
+bool DeferredEventBus::PostTo(std::weak_ptr<GameEntity> target, EntityEventType event, const EntityEventMessage& message)
+{
+	return Enqueue(event, message, std::move(target), false);
+}
+
+/// <summary>
+/// Claims the next free slot and writes the event to it.
+/// Bounded MPMC ring after Dmitry Vyukov's design, used here with a single consumer.
+/// </summary>
+bool DeferredEventBus::Enqueue(EntityEventType event, const EntityEventMessage& message, std::weak_ptr<GameEntity> target, bool broadcast)
+{
+	// Entity messages are raw pointers, which aren't safe to hold until the next frame
+	EventPayloadType required = GetEventPayloadType(event);
+	if (required == EVENT_PAYLOAD_ENTITY || (required != EVENT_PAYLOAD_NONE && message.GetType() != required)) return false;
+
+	Slot* slot;
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	while (true) {
+		slot = &slots[position & (Capacity - 1)];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+		if (difference == 0) {
+			// Free slot, try to claim it. On failure position is reloaded.
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+		}
+		else if (difference < 0) {
+			// The slot a full lap behind hasn't been drained yet
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else {
+			// Another producer claimed this slot first
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->entry.event = event;
+	slot->entry.message = message;
+	slot->entry.target = std::move(target);
+	slot->entry.broadcast = broadcast;
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+/// <summary>
+/// Delivers everything posted so far. Call once per frame from the main thread.
+/// Events are grouped by type, in EntityEventType order. Within a group, events
+/// sent to one entity go first, then broadcasts, each in the order they were
+/// posted. Broadcasts visit every entity once per group rather than once per event.
+/// Events posted while flushing wait for the next Flush.
+/// </summary>
+void DeferredEventBus::Flush()
+{
+	// Drain the ring first, and only up to what had been claimed on entry,
+	// so neither busy producers nor handlers that post again can keep this going
+	size_t end = enqueuePosition.load(std::memory_order_acquire);
+	lastFlushCount = 0;
+	while (dequeuePosition != end) {
+		Slot& slot = slots[dequeuePosition & (Capacity - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) break;
+
+		batches[slot.entry.event].push_back(std::move(slot.entry));
+		slot.entry.target.reset();
+		slot.entry.message = EntityEventMessage();
+
+		// Hand the slot back to producers for the next lap
+		slot.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+		dequeuePosition++;
+		lastFlushCount++;
+	}
+
+	if (lastFlushCount == 0) return;
+
+	for (int type = 0; type < EventCount; type++) {
+		std::vector<DeferredEvent>& batch = batches[type];
+		if (batch.empty()) continue;
+
+		for (DeferredEvent& deferred : batch) {
+			if (deferred.broadcast) {
+				broadcastBatch.push_back(std::move(deferred.message));
+			}
+			else if (std::shared_ptr<GameEntity> target = deferred.target.lock()) {
+				target->DeliverEvent(deferred.event, deferred.message);
+			}
+		}
+
+		if (!broadcastBatch.empty()) {
+			AssetManager::GetInstance().BroadcastGlobalEntityEvents((EntityEventType)type, broadcastBatch);
+			broadcastBatch.clear();
+		}
+
+		batch.clear();
+	}
+}
+
+/// <summary>
+/// Roughly how many events are waiting. Exact only on the main thread while no one is posting.
+/// </summary>
+size_t DeferredEventBus::GetPendingCount()
+{
+	return enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition;
+}
+
+/// <summary>
+/// How many posts have been rejected because the queue was full
+/// </summary>
+size_t DeferredEventBus::GetDroppedCount()
+{
+	return droppedCount.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// How many events the last Flush delivered
+/// </summary>
+size_t DeferredEventBus::GetLastFlushCount()
+{
+	return lastFlushCount;
+}
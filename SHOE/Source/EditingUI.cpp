@@ -5,6 +5,10 @@
 #include "..\Headers\ShadowProjector.h"
 #include "..\Headers\FlashlightController.h"
 #include "..\Headers\NoclipMovement.h"
+#include "..\Headers\SystemScheduler.h"
+#include "..\Headers\MemoryTracker.h"
+#include "..\Headers\EventTracer.h"
+#include "..\Headers\RenderSnapshot.h"
 #include <d3dcompiler.h>
 
 // Needed for a helper function to read compiled shader files from the hard drive
@@ -208,6 +212,11 @@ void EditingUI::DisplayMenu() {
 			ImGui::MenuItem("Toggle Stats Menu", ".", GetStatsEnabled());
 			ImGui::MenuItem("Toggle movement", "m", GetMovingEnabled());
 
+			bool deterministicSystems = SystemScheduler::GetInstance().GetDeterministic();
+			if (ImGui::MenuItem("Run Systems In Order", "", &deterministicSystems)) {
+				SystemScheduler::GetInstance().SetDeterministic(deterministicSystems);
+			}
+
 			ImGui::EndMenu();
 		}
 
@@ -350,11 +359,11 @@ std::shared_ptr<GameEntity> EditingUI::GetClickedEntity()
 	float distToHit = globalAssets.GetEditingCamera()->GetFarDist();
 	float rayLength = globalAssets.GetEditingCamera()->GetFarDist();
 
-	for (std::shared_ptr<MeshRenderer> meshRenderer : ComponentManager::GetAllEnabled<MeshRenderer>())
+	for (MeshRenderer& meshRenderer : ComponentManager::ViewEnabled<MeshRenderer>())
 	{
-		if (meshRenderer->GetBounds().Intersects(origin, direction, rayLength)) {
-			std::shared_ptr<Mesh> mesh = meshRenderer->GetMesh();
-			XMMATRIX worldMatrix = XMLoadFloat4x4(&meshRenderer->GetTransform()->GetWorldMatrix());
+		if (meshRenderer.GetBounds().Intersects(origin, direction, rayLength)) {
+			std::shared_ptr<Mesh> mesh = meshRenderer.GetMesh();
+			XMMATRIX worldMatrix = XMLoadFloat4x4(&meshRenderer.GetTransform()->GetWorldMatrix());
 			Vertex* vertices = mesh->GetVertexArray();
 			unsigned int* indices = mesh->GetIndexArray();
 			float distToTri;
@@ -366,7 +375,7 @@ std::shared_ptr<GameEntity> EditingUI::GetClickedEntity()
 				if (DirectX::TriangleTests::Intersects(origin, direction, vertex0, vertex1, vertex2, distToTri) && distToTri < distToHit)
 				{
 					distToHit = distToTri;
-					closestHitEntity = meshRenderer->GetGameEntity();
+					closestHitEntity = meshRenderer.GetGameEntity();
 				}
 			}
 		}
@@ -413,6 +422,84 @@ void EditingUI::GenerateEditingUI() {
 
 		ImGui::Text(node.c_str());
 
+		// Drawing behind the simulation blends its last two frames
+		float interpolationDelay = RenderSnapshotBuffer::GetInstance().GetInterpolationDelay();
+		ImGui::DragFloat("Interpolation Delay (s) ", &interpolationDelay, 0.001f, 0.0f, 0.1f);
+		RenderSnapshotBuffer::GetInstance().SetInterpolationDelay(interpolationDelay);
+
+		if (ImGui::CollapsingHeader("Memory")) {
+#if !SHOE_MEMORY_TRACKING
+			ImGui::Text("Allocation tracking is off in this build, only external allocations are counted");
+#endif
+			// Live / peak in KB, then allocations and KB allocated last frame
+			for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+				MemoryCategoryStats stats = MemoryTracker::GetStats((MemoryCategory)i);
+				node = std::string(MemoryTracker::GetCategoryName((MemoryCategory)i)) + ": " +
+					std::to_string(stats.liveBytes / 1024) + " KB live, " +
+					std::to_string(stats.peakBytes / 1024) + " KB peak, " +
+					std::to_string(stats.frameAllocations) + " allocs (" +
+					std::to_string(stats.frameBytes / 1024) + " KB) last frame";
+
+				ImGui::Text(node.c_str());
+			}
+
+			ImGui::Separator();
+
+			for (MemoryPoolStats& pool : MemoryTracker::GetPoolStats()) {
+				node = pool.name + ": " + std::to_string(pool.liveSlots) + " live, " +
+					std::to_string(pool.freeSlots) + " free, " +
+					std::to_string(pool.slotSize) + " bytes each";
+
+				ImGui::Text(node.c_str());
+			}
+
+			if (ImGui::Button("Dump to MemoryReport.json")) {
+				MemoryTracker::DumpToJSON("MemoryReport.json");
+			}
+		}
+
+#if SHOE_EVENT_TRACING
+		if (ImGui::CollapsingHeader("Events")) {
+			EventFrameStats frame;
+			if (EventTracer::GetLastFrame(frame) &&
+				ImGui::BeginTable("EventStats", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+				ImGui::TableSetupColumn("Event");
+				ImGui::TableSetupColumn("Sends");
+				ImGui::TableSetupColumn("Entities");
+				ImGui::TableSetupColumn("Components");
+				ImGui::TableSetupColumn("Largest Send");
+				ImGui::TableSetupColumn("ms");
+				ImGui::TableHeadersRow();
+
+				// Only types that fired last frame
+				for (int i = 0; i < EventCount; i++) {
+					EventTypeFrameStats& stats = frame.types[i];
+					if (stats.sends == 0 && stats.fanOut == 0) continue;
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(EventTracer::GetEventName((EntityEventType)i));
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", stats.sends);
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", stats.deliveries);
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", stats.fanOut);
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", stats.peakFanOut);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", stats.milliseconds);
+				}
+
+				ImGui::EndTable();
+			}
+
+			if (ImGui::Button("Export to EventTrace.json")) {
+				EventTracer::ExportChromeTrace("EventTrace.json");
+			}
+		}
+#endif
+
 		ImGui::End();
 	}
 
@@ -443,9 +530,9 @@ void EditingUI::GenerateEditingUI() {
 		static char nameBuf[64] = "";
 		nameBuffer = currentSky->GetName();
 		strcpy_s(nameBuf, nameBuffer.c_str());
-		ImGui::InputText("Rename Sky ", nameBuf, sizeof(nameBuffer));
-
-		currentSky->SetName(nameBuf);
+		if (ImGui::InputText("Rename Sky ", nameBuf, sizeof(nameBuffer))) {
+			currentSky->SetName(nameBuf);
+		}
 
 		bool skyEnabled = currentSky->IsEnabled();
 		ImGui::Checkbox("Enabled ##SkyEnabled", &skyEnabled);
@@ -491,9 +578,9 @@ void EditingUI::GenerateEditingUI() {
 		static char nameBuf[64] = "";
 		nameBuffer = currentTexture->GetName();
 		strcpy_s(nameBuf, nameBuffer.c_str());
-		ImGui::InputText("Rename Texture", nameBuf, sizeof(nameBuffer));
-
-		currentTexture->SetName(nameBuf);
+		if (ImGui::InputText("Rename Texture", nameBuf, sizeof(nameBuffer))) {
+			currentTexture->SetName(nameBuf);
+		}
 
 		ImGui::Separator();
 
@@ -535,9 +622,9 @@ void EditingUI::GenerateEditingUI() {
 		static char nameBuf[64] = "";
 		nameBuffer = currentEntity->GetName();
 		strcpy_s(nameBuf, nameBuffer.c_str());
-		ImGui::InputText("Rename GameObject", nameBuf, sizeof(nameBuffer));
-
-		currentEntity->SetName(nameBuf);
+		if (ImGui::InputText("Rename GameObject", nameBuf, sizeof(nameBuffer))) {
+			currentEntity->SetName(nameBuf);
+		}
 
 		bool entityEnabled = currentEntity->GetEnabled();
 		ImGui::Checkbox("Enabled: ", &entityEnabled);
@@ -1379,9 +1466,9 @@ void EditingUI::GenerateEditingUI() {
 		static char nameBuf[64] = "";
 		nameBuffer = currentMaterial->GetName();
 		strcpy_s(nameBuf, nameBuffer.c_str());
-		ImGui::InputText("Rename Material ", nameBuf, sizeof(nameBuffer));
-
-		currentMaterial->SetName(nameBuf);
+		if (ImGui::InputText("Rename Material ", nameBuf, sizeof(nameBuffer))) {
+			currentMaterial->SetName(nameBuf);
+		}
 
 		float currTiling = currentMaterial->GetTiling();
 		ImGui::InputFloat("Tiling ", &currTiling);
@@ -1668,9 +1755,9 @@ void EditingUI::GenerateEditingUI() {
 		static char nameBuf[64] = "";
 		nameBuffer = currentTMat->GetName();
 		strcpy_s(nameBuf, nameBuffer.c_str());
-		ImGui::InputText("Rename Terrain Material ", nameBuf, sizeof(nameBuffer));
-
-		currentTMat->SetName(nameBuf);
+		if (ImGui::InputText("Rename Terrain Material ", nameBuf, sizeof(nameBuffer))) {
+			currentTMat->SetName(nameBuf);
+		}
 
 		ImGui::Text("Current Materials in TMat List:");
 		for (int i = 0; i < currentTMat->GetMaterialCount(); i++) {
@@ -0,0 +1,134 @@
+#include "..\Headers\EntityCommandBuffer.h"
+
+#include <unordered_set>
+#include "..\Headers\AssetManager.h"
+
+// Singleton requirement
+EntityCommandBuffer* EntityCommandBuffer::instance;
+
+std::atomic<int> EntityCommandBuffer::iterationDepth = 0;
+
+EntityCommandBuffer::EntityCommandBuffer()
+{
+	commands = std::vector<EntityCommand>();
+	destroyed = std::vector<std::shared_ptr<GameEntity>>();
+	applyingCommands = std::vector<EntityCommand>();
+	applyingDestroyed = std::vector<std::shared_ptr<GameEntity>>();
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+	commands.clear();
+	destroyed.clear();
+	applyingCommands.clear();
+	applyingDestroyed.clear();
+}
+
+/// <summary>
+/// Creates a GameEntity at the next sync point
+/// </summary>
+/// <param name="name">Name of the new entity</param>
+/// <param name="onCreated">Called with the entity once it exists, to add components or set it up</param>
+void EntityCommandBuffer::CreateEntity(std::string name, std::function<void(std::shared_ptr<GameEntity>)> onCreated)
+{
+	Record(nullptr, [name, onCreated]() {
+		std::shared_ptr<GameEntity> entity = AssetManager::GetInstance().CreateGameEntity(name);
+		if (onCreated) onCreated(entity);
+	});
+}
+
+/// <summary>
+/// Releases and removes a GameEntity at the next sync point.
+/// Any other commands recorded against it in the same batch are dropped.
+/// </summary>
+void EntityCommandBuffer::DestroyEntity(std::shared_ptr<GameEntity> entity)
+{
+	if (entity == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(recordMutex);
+	destroyed.push_back(entity);
+}
+
+/// <summary>
+/// Enables or disables a GameEntity at the next sync point, sending
+/// OnEnable or OnDisable to it and its children then
+/// </summary>
+void EntityCommandBuffer::SetEnabled(std::shared_ptr<GameEntity> entity, bool enabled)
+{
+	if (entity == nullptr) return;
+
+	Record(entity, [entity, enabled]() { entity->SetEnabled(enabled); });
+}
+
+/// <summary>
+/// Removes a specific component from an entity at the next sync point
+/// </summary>
+void EntityCommandBuffer::RemoveComponent(std::shared_ptr<GameEntity> entity, std::shared_ptr<IComponent> component)
+{
+	Record(entity, [entity, component]() { entity->RemoveComponent(component); });
+}
+
+/// <summary>
+/// Applies everything recorded so far. Call once per frame from the main
+/// thread, outside any IterationScope.
+/// </summary>
+void EntityCommandBuffer::Apply()
+{
+	{
+		std::lock_guard<std::mutex> lock(recordMutex);
+		applyingCommands.swap(commands);
+		applyingDestroyed.swap(destroyed);
+	}
+
+	if (applyingCommands.empty() && applyingDestroyed.empty()) return;
+
+	std::unordered_set<GameEntity*> destroying;
+	for (std::shared_ptr<GameEntity>& entity : applyingDestroyed) {
+		destroying.insert(entity.get());
+	}
+
+	for (EntityCommand& command : applyingCommands) {
+		if (command.entity != nullptr && destroying.count(command.entity.get()) > 0) continue;
+		command.apply();
+	}
+
+	if (!applyingDestroyed.empty()) {
+		AssetManager::GetInstance().RemoveGameEntities(applyingDestroyed);
+	}
+
+	applyingCommands.clear();
+	applyingDestroyed.clear();
+}
+
+/// <summary>
+/// How many commands are waiting for the next Apply
+/// </summary>
+size_t EntityCommandBuffer::GetCommandCount()
+{
+	std::lock_guard<std::mutex> lock(recordMutex);
+	return commands.size() + destroyed.size();
+}
+
+EntityCommandBuffer::IterationScope::IterationScope()
+{
+	iterationDepth++;
+}
+
+EntityCommandBuffer::IterationScope::~IterationScope()
+{
+	iterationDepth--;
+}
+
+/// <summary>
+/// Whether any IterationScope is open, in which case structural changes have to be recorded
+/// </summary>
+bool EntityCommandBuffer::IsIterating()
+{
+	return iterationDepth > 0;
+}
+
+void EntityCommandBuffer::Record(std::shared_ptr<GameEntity> entity, std::function<void()> apply)
+{
+	std::lock_guard<std::mutex> lock(recordMutex);
+	commands.push_back({ entity, apply });
+}
@@ -0,0 +1,286 @@
+#include "..\Headers\EventTracer.h"
+
+#include <atomic>
+#include <chrono>
+#include "rapidjson\filewritestream.h"
+#include "rapidjson\writer.h"
+
+namespace {
+	struct EventTypeCounters
+	{
+		std::atomic<uint32_t> sends;
+		std::atomic<uint32_t> deliveries;
+		std::atomic<uint32_t> fanOut;
+		std::atomic<uint32_t> peakFanOut;
+		std::atomic<int64_t> nanoseconds;
+	};
+
+	EventTypeCounters counters[EventCount];
+	std::atomic<unsigned int> frameNumber;
+
+	// How deep each event type's dispatches are nested on this thread,
+	// and how many components each type has reached on it so far
+	thread_local uint32_t dispatchDepth[EventCount];
+	thread_local uint32_t threadFanOut[EventCount];
+
+	const char* eventNames[] = {
+		"Update",
+		"EditingUpdate",
+		"OnEnable",
+		"OnDisable",
+		"OnTransform",
+		"OnMove",
+		"OnRotate",
+		"OnScale",
+		"OnParentTransform",
+		"OnParentMove",
+		"OnParentRotate",
+		"OnParentScale",
+		"OnParentEnabledChanged",
+		"OnCollisionEnter",
+		"OnTriggerEnter",
+		"InCollision",
+		"InTrigger",
+		"OnCollisionExit",
+		"OnTriggerExit",
+		"OnAudioLoad",
+		"OnAudioPlay",
+		"OnAudioPause",
+		"OnAudioEnd"
+	};
+	static_assert(sizeof(eventNames) / sizeof(eventNames[0]) == EventCount, "Every EntityEventType needs a name");
+
+	int64_t Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	const int64_t traceStart = Now();
+	int64_t frameStart = traceStart;
+}
+
+EventFrameStats EventTracer::history[EventTracer::HistoryLength];
+size_t EventTracer::historyCount = 0;
+size_t EventTracer::nextHistoryIndex = 0;
+
+const char* EventTracer::GetEventName(EntityEventType event)
+{
+	return eventNames[event];
+}
+
+/// <summary>
+/// Moves this frame's counts into the history and starts the next frame. Call once per frame.
+/// </summary>
+void EventTracer::EndFrame()
+{
+	int64_t now = Now();
+
+	EventFrameStats& frame = history[nextHistoryIndex];
+	frame.frame = frameNumber.fetch_add(1, std::memory_order_relaxed);
+	frame.startTime = (frameStart - traceStart) / 1000000.0;
+	frame.duration = (now - frameStart) / 1000000.0;
+
+	for (int i = 0; i < EventCount; i++) {
+		EventTypeCounters& counter = counters[i];
+		frame.types[i].sends = counter.sends.exchange(0, std::memory_order_relaxed);
+		frame.types[i].deliveries = counter.deliveries.exchange(0, std::memory_order_relaxed);
+		frame.types[i].fanOut = counter.fanOut.exchange(0, std::memory_order_relaxed);
+		frame.types[i].peakFanOut = counter.peakFanOut.exchange(0, std::memory_order_relaxed);
+		frame.types[i].milliseconds = counter.nanoseconds.exchange(0, std::memory_order_relaxed) / 1000000.0;
+	}
+
+	nextHistoryIndex = (nextHistoryIndex + 1) % HistoryLength;
+	if (historyCount < HistoryLength) historyCount++;
+	frameStart = now;
+}
+
+/// <summary>
+/// Copies out the most recently completed frame
+/// </summary>
+/// <returns>False if no frame has completed yet</returns>
+bool EventTracer::GetLastFrame(EventFrameStats& stats)
+{
+	if (historyCount == 0) return false;
+
+	stats = history[(nextHistoryIndex + HistoryLength - 1) % HistoryLength];
+	return true;
+}
+
+/// <summary>
+/// Every frame still in the ring buffer, oldest first
+/// </summary>
+std::vector<EventFrameStats> EventTracer::GetHistory()
+{
+	std::vector<EventFrameStats> frames = std::vector<EventFrameStats>();
+	frames.reserve(historyCount);
+
+	size_t first = (nextHistoryIndex + HistoryLength - historyCount) % HistoryLength;
+	for (size_t i = 0; i < historyCount; i++) {
+		frames.push_back(history[(first + i) % HistoryLength]);
+	}
+	return frames;
+}
+
+/// <summary>
+/// Writes the history as a Chrome trace, viewable in chrome://tracing or Perfetto.
+/// Each event type gets its own track, with one span per frame as long as the
+/// type's total time that frame, and the counts attached as arguments.
+/// Fan-out per type is also written as a counter track.
+/// </summary>
+/// <param name="filepath">Full path of the file to write</param>
+/// <returns>Whether the file could be opened</returns>
+bool EventTracer::ExportChromeTrace(std::string filepath)
+{
+	FILE* file;
+	fopen_s(&file, filepath.c_str(), "w");
+	if (file == NULL) return false;
+
+	char writeBuffer[4096];
+	rapidjson::FileWriteStream stream(file, writeBuffer, sizeof(writeBuffer));
+	rapidjson::Writer<rapidjson::FileWriteStream> writer(stream);
+
+	writer.StartObject();
+	writer.Key("displayTimeUnit");
+	writer.String("ms");
+	writer.Key("traceEvents");
+	writer.StartArray();
+
+	// Track names. Frames go on track 0, each event type on the track after its enum value.
+	for (int track = 0; track <= EventCount; track++) {
+		writer.StartObject();
+		writer.Key("name");
+		writer.String("thread_name");
+		writer.Key("ph");
+		writer.String("M");
+		writer.Key("pid");
+		writer.Int(0);
+		writer.Key("tid");
+		writer.Int(track);
+		writer.Key("args");
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(track == 0 ? "Frames" : GetEventName((EntityEventType)(track - 1)));
+		writer.EndObject();
+		writer.EndObject();
+	}
+
+	for (EventFrameStats& frame : GetHistory()) {
+		double frameMicroseconds = frame.startTime * 1000.0;
+
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(("Frame " + std::to_string(frame.frame)).c_str());
+		writer.Key("ph");
+		writer.String("X");
+		writer.Key("pid");
+		writer.Int(0);
+		writer.Key("tid");
+		writer.Int(0);
+		writer.Key("ts");
+		writer.Double(frameMicroseconds);
+		writer.Key("dur");
+		writer.Double(frame.duration * 1000.0);
+		writer.EndObject();
+
+		for (int i = 0; i < EventCount; i++) {
+			EventTypeFrameStats& stats = frame.types[i];
+			if (stats.sends == 0 && stats.fanOut == 0) continue;
+
+			writer.StartObject();
+			writer.Key("name");
+			writer.String(GetEventName((EntityEventType)i));
+			writer.Key("ph");
+			writer.String("X");
+			writer.Key("pid");
+			writer.Int(0);
+			writer.Key("tid");
+			writer.Int(i + 1);
+			writer.Key("ts");
+			writer.Double(frameMicroseconds);
+			writer.Key("dur");
+			writer.Double(stats.milliseconds * 1000.0);
+			writer.Key("args");
+			writer.StartObject();
+			writer.Key("sends");
+			writer.Uint(stats.sends);
+			writer.Key("deliveries");
+			writer.Uint(stats.deliveries);
+			writer.Key("fanOut");
+			writer.Uint(stats.fanOut);
+			writer.Key("peakFanOut");
+			writer.Uint(stats.peakFanOut);
+			writer.EndObject();
+			writer.EndObject();
+		}
+
+		writer.StartObject();
+		writer.Key("name");
+		writer.String("Event fan-out");
+		writer.Key("ph");
+		writer.String("C");
+		writer.Key("pid");
+		writer.Int(0);
+		writer.Key("ts");
+		writer.Double(frameMicroseconds);
+		writer.Key("args");
+		writer.StartObject();
+		for (int i = 0; i < EventCount; i++) {
+			if (frame.types[i].fanOut == 0) continue;
+			writer.Key(GetEventName((EntityEventType)i));
+			writer.Uint(frame.types[i].fanOut);
+		}
+		writer.EndObject();
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+	writer.EndObject();
+	stream.Flush();
+
+	fclose(file);
+	return true;
+}
+
+/// <summary>
+/// Counts an entity being sent an event
+/// </summary>
+void EventTracer::RecordDelivery(EntityEventType event)
+{
+	counters[event].deliveries.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Counts a component's ReceiveEvent running
+/// </summary>
+void EventTracer::RecordReceive(EntityEventType event)
+{
+	counters[event].fanOut.fetch_add(1, std::memory_order_relaxed);
+	threadFanOut[event]++;
+}
+
+EventDispatchScope::EventDispatchScope(EntityEventType event)
+{
+	this->event = event;
+	this->outermost = dispatchDepth[event]++ == 0;
+	this->startTicks = 0;
+	this->startFanOut = 0;
+
+	if (outermost) {
+		counters[event].sends.fetch_add(1, std::memory_order_relaxed);
+		startFanOut = threadFanOut[event];
+		startTicks = Now();
+	}
+}
+
+EventDispatchScope::~EventDispatchScope()
+{
+	dispatchDepth[event]--;
+	if (!outermost) return;
+
+	EventTypeCounters& counter = counters[event];
+	counter.nanoseconds.fetch_add(Now() - startTicks, std::memory_order_relaxed);
+
+	uint32_t fanOut = threadFanOut[event] - startFanOut;
+	uint32_t peak = counter.peakFanOut.load(std::memory_order_relaxed);
+	while (fanOut > peak && !counter.peakFanOut.compare_exchange_weak(peak, fanOut, std::memory_order_relaxed)) {}
+}
@@ -1 +1,23 @@
 #include "..\Headers\FlashlightController.h"
+#include "..\Headers\GameEntity.h"
+#include "..\Headers\ComponentManager.h"
+#include "..\Headers\EntityCommandBuffer.h"
+#include "..\Headers\Input.h"
+
+/// <summary>
+/// Flips every flashlight entity on or off when the toggle key is pressed.
+/// Runs as a scheduled system, since a disabled flashlight still has to
+/// listen for the key. The flips are recorded into the EntityCommandBuffer,
+/// so this touches no components and can run alongside other systems, and
+/// they take effect at the end of the frame.
+/// </summary>
+void FlashlightController::ToggleAll()
+{
+	if (!Input::GetInstance().TestKeyAction(KeyActions::ToggleFlashlight)) return;
+
+	EntityCommandBuffer& commands = EntityCommandBuffer::GetInstance();
+	for (FlashlightController& flashlight : ComponentManager::View<FlashlightController>()) {
+		std::shared_ptr<GameEntity> entity = flashlight.GetGameEntity();
+		commands.SetEnabled(entity, !entity->GetLocallyEnabled());
+	}
+}
\ No newline at end of file
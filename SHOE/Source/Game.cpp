@@ -4,6 +4,13 @@
 #include "..\Headers\ShadowProjector.h"
 #include "..\Headers\FlashlightController.h"
 #include "..\Headers\NoclipMovement.h"
+#include "..\Headers\AudioResponse.h"
+#include "..\Headers\SystemScheduler.h"
+#include "..\Headers\EntityCommandBuffer.h"
+#include "..\Headers\MemoryTracker.h"
+#include "..\Headers\DeferredEventBus.h"
+#include "..\Headers\EventTracer.h"
+#include "..\Headers\RenderQueue.h"
 #include <d3dcompiler.h>
 
 // Needed for a helper function to read compiled shader files from the hard drive
@@ -82,6 +89,14 @@ Game::Game(HINSTANCE hInstance, LPSTR cmdLine)
 				SetHasStartupScene(true);
 			}
 
+			if (!firstHalfOfParameter.compare("/MemoryReport")) {
+				memoryReportPath = secondHalfOfParameter;
+			}
+
+			if (!firstHalfOfParameter.compare("/EventTrace")) {
+				eventTracePath = secondHalfOfParameter;
+			}
+
 			if (end == std::string::npos) {
 				// Loop's over, break
 				// Can't just have this be the loop condition,
@@ -128,6 +143,15 @@ Game::~Game()
 	// - If we weren't using smart pointers, we'd need
 	//   to call Release() on each DirectX object created in Game
 
+	// Written before anything is torn down, so it reflects the running scene
+	if (!memoryReportPath.empty()) {
+		MemoryTracker::DumpToJSON(memoryReportPath);
+	}
+
+	if (!eventTracePath.empty()) {
+		EventTracer::ExportChromeTrace(eventTracePath);
+	}
+
 	ImGui_ImplDX11_Shutdown();
 	ImGui_ImplWin32_Shutdown();
 	ImGui::DestroyContext();
@@ -137,6 +161,9 @@ Game::~Game()
 	delete& AudioHandler::GetInstance();
 	delete& CollisionManager::GetInstance();
 	delete& SceneManager::GetInstance();
+	delete& SystemScheduler::GetInstance();
+	delete& EntityCommandBuffer::GetInstance();
+	delete& DeferredEventBus::GetInstance();
 
 	delete loadingSpriteBatch;
 }
@@ -149,6 +176,9 @@ void Game::Init()
 {
 	engineState = EngineState::INIT;
 
+	// Created before any audio or loading threads can post to it
+	DeferredEventBus::GetInstance();
+
 	if (!IsDirectX12()) {
 		loadingSpriteBatch = new SpriteBatch(context.Get());
 
@@ -191,6 +221,16 @@ void Game::Init()
 	// Initialize the input manager with the window's handle
 	Input::GetInstance().Initialize(this->hWnd);
 
+	// Systems that tick outside the entity broadcasts, in the order they should run when they conflict.
+	// The flashlight toggle only records commands, so it runs alongside NoclipMovement.
+	// Its flips used to land before the collision pass, and now land at the end of the
+	// frame, so collisions and ticks see them from the next frame on.
+	SystemScheduler& scheduler = SystemScheduler::GetInstance();
+	scheduler.RegisterSystem("FlashlightController", EntityEventType::Update, ComponentAccess<FlashlightController>::mask, ComponentAccess<>::mask, FlashlightController::ToggleAll);
+	scheduler.RegisterComponentSystem<NoclipMovement>(EntityEventType::Update);
+	scheduler.RegisterComponentSystem<AudioResponse>(EntityEventType::Update);
+	scheduler.RegisterComponentSystem<AudioResponse>(EntityEventType::EditingUpdate);
+
 	//With everything initialized, start the renderer
 
 	// What graphics library are we using?
@@ -258,6 +298,9 @@ void Game::Update()
 {
 	audioHandler.GetSoundSystem()->update();
 
+	// Events posted off the main thread since last frame, including this update's audio callbacks
+	DeferredEventBus::GetInstance().Flush();
+
 	switch (engineState) {
 	case EngineState::EDITING:
 		// Quit if the escape key is pressed
@@ -266,7 +309,8 @@ void Game::Update()
 			editUI->GenerateEditingUI();
 
 			globalAssets.UpdateEditingCamera();
-			globalAssets.BroadcastGlobalEntityEvent(EntityEventType::EditingUpdate);
+			SystemScheduler::GetInstance().Run(EntityEventType::EditingUpdate);
+			ComponentTicks::Run(EntityEventType::EditingUpdate);
 		}
 		break;
 	case EngineState::PLAY:
@@ -274,18 +318,35 @@ void Game::Update()
 			sceneManager.PostPlayLoad();
 		}
 		else {
-			if (input.TestKeyAction(KeyActions::ToggleFlashlight)) {
-				for (std::shared_ptr<FlashlightController> flashlight : ComponentManager::GetAll<FlashlightController>()) {
-					flashlight->GetGameEntity()->SetEnabled(!flashlight->GetGameEntity()->GetLocallyEnabled());
-				}
-			}
-
 			CollisionManager::GetInstance().Update();
 
-			globalAssets.BroadcastGlobalEntityEvent(EntityEventType::Update);
+			SystemScheduler::GetInstance().Run(EntityEventType::Update);
+			ComponentTicks::Run(EntityEventType::Update);
 		}
 		break;
 	}
+
+	// Sync point for structural changes recorded during the frame
+	EntityCommandBuffer::GetInstance().Apply();
+
+	// Every world matrix moved this frame in one pass, parents first,
+	// so the handlers notified below read them without recomputing
+	TransformHierarchy::UpdateWorldMatrices();
+
+	// One combined notification per moved subtree, after everything has moved
+	Transform::NotifyChanges();
+
+	// Hand the finished frame to the renderer, which draws from the snapshot
+	// rather than the live scene
+	RenderSnapshotBuffer& snapshots = RenderSnapshotBuffer::GetInstance();
+	RenderQueue::GetInstance().Capture(snapshots.GetWriteSnapshot());
+	snapshots.Publish();
+
+	MemoryTracker::EndFrame();
+
+#if SHOE_EVENT_TRACING
+	EventTracer::EndFrame();
+#endif
 }
 
 void Game::DrawInitializingScreen(std::string category)
@@ -421,6 +482,9 @@ void Game::DrawLoadingScreen() {
 // --------------------------------------------------------
 void Game::Draw()
 {
+	// Newest frame the simulation has published, if any since the last draw
+	RenderSnapshotBuffer::GetInstance().Acquire();
+
 	switch (dxVersion) {
 	case DIRECT_X_11:
 		if (engineState == EngineState::EDITING) {
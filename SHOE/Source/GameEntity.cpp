@@ -1,4 +1,9 @@
 #include "../Headers/GameEntity.h"
+#include <cassert>
+#include "../Headers/AssetNameIndex.h"
+#include "../Headers/EntityCommandBuffer.h"
+#include "../Headers/SystemScheduler.h"
+#include "../Headers/EventTracer.h"
 
 /**
  * \brief Updates children and attached components with whether the object's parent is enabled
@@ -9,9 +14,13 @@ void GameEntity::UpdateHierarchyIsEnabled(bool active, bool head)
 	if (head || hierarchyIsEnabled != active) {
 		if (!head) { 
 			hierarchyIsEnabled = active;
-			if (enabled && !hierarchyIsEnabled) PropagateEvent(EntityEventType::OnDisable);
+			if (enabled && !hierarchyIsEnabled) PropagateEvent<EntityEventType::OnDisable>();
 		}
-		PropagateEvent(EntityEventType::OnEnable); //Safe to call as it won't propagate to disabled components
+		for (IComponent* component : boundComponents)
+		{
+			component->RefreshEnabledState();
+		}
+		PropagateEvent<EntityEventType::OnEnable>(); //Safe to call as it won't propagate to disabled components
 		for (std::shared_ptr<GameEntity> children : transform->GetChildrenEntities())
 		{
 			if (children != nullptr)
@@ -23,6 +32,9 @@ void GameEntity::UpdateHierarchyIsEnabled(bool active, bool head)
 GameEntity::GameEntity(std::string name) {
 	this->componentList = std::vector<std::shared_ptr<IComponent>>();
 	this->componentDeallocList = std::vector<std::function<void(std::shared_ptr<IComponent>)>>();
+	this->componentTypeList = std::vector<ComponentTypes>();
+	this->componentEventMasks = std::vector<EntityEventMask>();
+	UpdateComponentTable();
 	this->name = name;
 	this->enabled = true;
 	this->hierarchyIsEnabled = true;
@@ -46,22 +58,16 @@ void GameEntity::Initialize()
 /// </summary>
 /// <param name="event">Message type to send</param>
 /// <param name="message">Body of the message, should one be needed</param>
-void GameEntity::PropagateEvent(EntityEventType event, std::shared_ptr<void> message)
+void GameEntity::PropagateEvent(EntityEventType event, const EntityEventMessage& message)
 {
-	//If the event type requires there to be a message and there isn't one, fail
-	if ((EntityEventType::REQUIRES_MESSAGE & 1 << event) && message == nullptr) {
+	//If the event type requires a message and this isn't one, fail
+	EventPayloadType required = GetEventPayloadType(event);
+	if (required != EVENT_PAYLOAD_NONE && message.GetType() != required) {
 		//Probably should throw but I'll silently fail for now
 		return;
 	}
 
-	//Propagates the event to all attached components
-	if (GetEnabled() || event == EntityEventType::OnDisable){
-		transform->ReceiveEvent(event, message);
-		for (std::shared_ptr<IComponent> component : componentList) {
-			if (component->IsEnabled() || (event == EntityEventType::OnDisable && component->IsLocallyEnabled()))
-				component->ReceiveEvent(event, message);
-		}
-	}
+	DeliverEvent(event, message);
 }
 
 /// <summary>
@@ -69,12 +75,53 @@ void GameEntity::PropagateEvent(EntityEventType event, std::shared_ptr<void> mes
 /// </summary>
 /// <param name="event">Message type to send</param>
 /// <param name="message">Body of the message, should one be needed</param>
-void GameEntity::PropagateEventToChildren(EntityEventType event, std::shared_ptr<void> message)
+void GameEntity::PropagateEventToChildren(EntityEventType event, const EntityEventMessage& message)
+{
+	EventPayloadType required = GetEventPayloadType(event);
+	if (required != EVENT_PAYLOAD_NONE && message.GetType() != required) return;
+
+	DeliverEventToChildren(event, message);
+}
+
+/// <summary>
+/// PropagateEvent without the message check, for messages already known to match
+/// </summary>
+void GameEntity::DeliverEvent(EntityEventType event, const EntityEventMessage& message)
 {
+	TRACE_EVENT_DISPATCH(event);
+	TRACE_EVENT_DELIVERY(event);
+
+	//Nothing on this entity handles the event
+	EntityEventMask eventBit = (EntityEventMask)1 << event;
+	if (!(eventMask & eventBit)) return;
+
+	//Ticks for scheduled component types are run by the SystemScheduler instead
+	ComponentMask scheduledTypes = 0;
+	if (event == EntityEventType::Update || event == EntityEventType::EditingUpdate)
+		scheduledTypes = SystemScheduler::GetInstance().GetScheduledTypes(event);
+
+	//Propagates the event to all attached components that handle it
+	if (GetEnabled() || event == EntityEventType::OnDisable){
+		if (ComponentEventTraits<Transform>::mask & eventBit) transform->ReceiveEvent(event, message);
+		for (size_t i = 0; i < componentList.size(); i++) {
+			if (!(componentEventMasks[i] & eventBit)) continue;
+			if (scheduledTypes & ((ComponentMask)1 << componentTypeList[i])) continue;
+
+			std::shared_ptr<IComponent> component = componentList[i];
+			if (component->IsEnabled() || (event == EntityEventType::OnDisable && component->IsLocallyEnabled()))
+				component->ReceiveEvent(event, message);
+		}
+	}
+}
+
+void GameEntity::DeliverEventToChildren(EntityEventType event, const EntityEventMessage& message)
+{
+	TRACE_EVENT_DISPATCH(event);
+
 	for (std::shared_ptr<GameEntity> child : transform->GetChildrenEntities())
 	{
 		if (child != nullptr)
-			child->PropagateEvent(event, message);
+			child->DeliverEvent(event, message);
 	}
 }
 
@@ -94,10 +141,13 @@ std::vector<std::shared_ptr<IComponent>> GameEntity::GetAllComponents()
 }
 
 /**
- * \brief Frees all of the stored objects in the entity so it can be safely destroyed
+ * \brief Frees all of the stored objects in the entity so it can be safely destroyed.
+ * Goes through AssetManager::RemoveGameEntity, which defers it while pools are being iterated.
  */
 void GameEntity::Release()
 {
+	assert(!EntityCommandBuffer::IsIterating());
+
 	for(std::shared_ptr<GameEntity> child : transform->GetChildrenEntities())
 	{
 		if (child != nullptr) {
@@ -117,7 +167,9 @@ std::string GameEntity::GetName() {
 }
 
 void GameEntity::SetName(std::string Name) {
+	if (this->name == Name) return;
 	this->name = Name;
+	AssetRenames<GameEntity>::Notify();
 }
 
 /// <summary>
@@ -127,7 +179,7 @@ void GameEntity::SetName(std::string Name) {
 void GameEntity::SetEnabled(bool value) {
 	if (enabled != value) {
 		this->enabled = value;
-		if (!value && hierarchyIsEnabled) PropagateEvent(EntityEventType::OnDisable);
+		if (!value && hierarchyIsEnabled) PropagateEvent<EntityEventType::OnDisable>();
 		UpdateHierarchyIsEnabled(GetEnabled(), true);
 	}
 }
@@ -168,12 +220,93 @@ bool GameEntity::RemoveComponent(std::shared_ptr<IComponent> component)
 	{
 		if (componentList[i] == component)
 		{
-			componentList[i]->OnDestroy();
-			componentDeallocList[i](componentList[i]);
-			componentList.erase(componentList.begin() + i);
-			componentDeallocList.erase(componentDeallocList.begin() + i);
+			RemoveComponentAt(i);
 			return true;
 		}
 	}
 	return false;
 }
+
+/// <summary>
+/// Adds an already instantiated component to this entity's lists and type table
+/// </summary>
+/// <param name="component">The component to track</param>
+/// <param name="type">Its ComponentTypes entry, or COMPONENT_TYPE_COUNT if it has none</param>
+/// <param name="events">Events its type handles, from ComponentEventTraits</param>
+/// <param name="dealloc">How to return it to its pool</param>
+void GameEntity::AttachComponent(std::shared_ptr<IComponent> component, ComponentTypes type, EntityEventMask events, std::function<void(std::shared_ptr<IComponent>)> dealloc)
+{
+	componentList.push_back(component);
+	componentDeallocList.push_back(dealloc);
+	componentTypeList.push_back(type);
+	componentEventMasks.push_back(events);
+	eventMask |= events;
+	if (type != COMPONENT_TYPE_COUNT && firstComponentOfType[type] == -1) {
+		firstComponentOfType[type] = (int)componentList.size() - 1;
+		componentMask |= (ComponentMask)1 << type;
+	}
+}
+
+/// <summary>
+/// While pools are being iterated, records a change to this entity into the
+/// EntityCommandBuffer for its next sync point instead of making it now
+/// </summary>
+/// <returns>Whether the change was recorded rather than made</returns>
+bool GameEntity::DeferWhileIterating(std::function<void()> change)
+{
+	if (!EntityCommandBuffer::IsIterating()) return false;
+
+	EntityCommandBuffer::GetInstance().Record(shared_from_this(), change);
+	return true;
+}
+
+/// <summary>
+/// Destroys, frees, and stops tracking the component at a position in componentList.
+/// While pools are being iterated this is recorded into the EntityCommandBuffer instead.
+/// </summary>
+void GameEntity::RemoveComponentAt(int index)
+{
+	if (EntityCommandBuffer::IsIterating()) {
+		EntityCommandBuffer::GetInstance().RemoveComponent(shared_from_this(), componentList[index]);
+		return;
+	}
+
+	componentList[index]->OnDestroy();
+	componentDeallocList[index](componentList[index]);
+	componentList.erase(componentList.begin() + index);
+	componentDeallocList.erase(componentDeallocList.begin() + index);
+	componentTypeList.erase(componentTypeList.begin() + index);
+	componentEventMasks.erase(componentEventMasks.begin() + index);
+	UpdateComponentTable();
+}
+
+/// <summary>
+/// Rebuilds the type and event masks and first-of-type indices from the component lists
+/// </summary>
+void GameEntity::UpdateComponentTable()
+{
+	eventMask = ComponentEventTraits<Transform>::mask;
+	for (EntityEventMask events : componentEventMasks) {
+		eventMask |= events;
+	}
+
+	componentMask = (ComponentMask)1 << TRANSFORM;
+	for (int i = 0; i < COMPONENT_TYPE_COUNT; i++) {
+		firstComponentOfType[i] = -1;
+	}
+	for (int i = (int)componentTypeList.size() - 1; i >= 0; i--) {
+		ComponentTypes type = componentTypeList[i];
+		if (type == COMPONENT_TYPE_COUNT) continue;
+		firstComponentOfType[type] = i;
+		componentMask |= (ComponentMask)1 << type;
+	}
+}
+
+/// <summary>
+/// Bitmask of every registered component type attached to this entity.
+/// The transform bit is always set since every entity has one.
+/// </summary>
+ComponentMask GameEntity::GetComponentMask()
+{
+	return componentMask;
+}
@@ -1,6 +1,18 @@
 #include "..\Headers\IComponent.h"
 #include "..\Headers\GameEntity.h"
 #include "..\Headers\Light.h"
+#include "..\Headers\ComponentView.h"
+#include "..\Headers\EventTracer.h"
+
+/**
+ * \return The entity this message carries, or nullptr if it carries none
+ */
+std::shared_ptr<GameEntity> EntityEventMessage::GetEntity() const
+{
+	GameEntity* const* entity = std::get_if<EVENT_PAYLOAD_ENTITY>(&payload);
+	if (entity == nullptr || *entity == nullptr) return nullptr;
+	return (*entity)->shared_from_this();
+}
 
 /**
  * \brief Called when the component is added to a GameEntity
@@ -23,8 +35,10 @@ void IComponent::EditingUpdate()
 {
 }
 
-void IComponent::ReceiveEvent(EntityEventType event, std::shared_ptr<void> message)
+void IComponent::ReceiveEvent(EntityEventType event, const EntityEventMessage& message)
 {
+	TRACE_EVENT_RECEIVE(event);
+
 	switch (event) {
 	case EntityEventType::Update:
 		Update();
@@ -42,55 +56,55 @@ void IComponent::ReceiveEvent(EntityEventType event, std::shared_ptr<void> messa
 		OnTransform();
 		break;
 	case EntityEventType::OnMove:
-		OnMove(*std::static_pointer_cast<DirectX::XMFLOAT3>(message));
+		OnMove(message.GetVector());
 		break;
 	case EntityEventType::OnRotate:
-		OnRotate(*std::static_pointer_cast<DirectX::XMFLOAT3>(message));
+		OnRotate(message.GetVector());
 		break;
 	case EntityEventType::OnScale:
-		OnScale(*std::static_pointer_cast<DirectX::XMFLOAT3>(message));
+		OnScale(message.GetVector());
 		break;
 	case EntityEventType::OnParentTransform:
-		OnParentTransform(std::static_pointer_cast<GameEntity>(message));
+		OnParentTransform(message.GetEntity());
 		break;
 	case EntityEventType::OnParentMove:
-		OnParentMove(std::static_pointer_cast<GameEntity>(message));
+		OnParentMove(message.GetEntity());
 		break;
 	case EntityEventType::OnParentRotate:
-		OnParentRotate(std::static_pointer_cast<GameEntity>(message));
+		OnParentRotate(message.GetEntity());
 		break;
 	case EntityEventType::OnParentScale:
-		OnParentScale(std::static_pointer_cast<GameEntity>(message));
+		OnParentScale(message.GetEntity());
 		break;
 	case EntityEventType::OnCollisionEnter:
-		OnCollisionEnter(std::static_pointer_cast<GameEntity>(message));
+		OnCollisionEnter(message.GetEntity());
 		break;
 	case EntityEventType::OnTriggerEnter:
-		OnTriggerEnter(std::static_pointer_cast<GameEntity>(message));
+		OnTriggerEnter(message.GetEntity());
 		break;
 	case EntityEventType::InCollision:
-		InCollision(std::static_pointer_cast<GameEntity>(message));
+		InCollision(message.GetEntity());
 		break;
 	case EntityEventType::InTrigger:
-		InTrigger(std::static_pointer_cast<GameEntity>(message));
+		InTrigger(message.GetEntity());
 		break;
 	case EntityEventType::OnCollisionExit:
-		OnCollisionExit(std::static_pointer_cast<GameEntity>(message));
+		OnCollisionExit(message.GetEntity());
 		break;
 	case EntityEventType::OnTriggerExit:
-		OnTriggerExit(std::static_pointer_cast<GameEntity>(message));
+		OnTriggerExit(message.GetEntity());
 		break;
 	case EntityEventType::OnAudioLoad:
-		OnAudioLoad(*std::static_pointer_cast<AudioEventPacket>(message));
+		OnAudioLoad(message.GetAudio());
 		break;
 	case EntityEventType::OnAudioPlay:
-		OnAudioPlay(*std::static_pointer_cast<AudioEventPacket>(message));
+		OnAudioPlay(message.GetAudio());
 		break;
 	case EntityEventType::OnAudioPause:
-		OnAudioPause(*std::static_pointer_cast<AudioEventPacket>(message));
+		OnAudioPause(message.GetAudio());
 		break;
 	case EntityEventType::OnAudioEnd:
-		OnAudioEnd(*std::static_pointer_cast<AudioEventPacket>(message));
+		OnAudioEnd(message.GetAudio());
 		break;
 	}
 }
@@ -151,7 +165,7 @@ void IComponent::OnTriggerExit(std::shared_ptr<GameEntity> other)
 }
 
 /**
- * \brief Called when this entity's transform is changed
+ * \brief Called once at the end of a frame in which this entity's transform was changed
  */
 void IComponent::OnTransform()
 {
@@ -182,15 +196,16 @@ void IComponent::OnScale(DirectX::XMFLOAT3 delta)
 }
 
 /**
- * \brief Called when a parent's transform is changed
- * \param parent std::shared_ptr<GameEntity> The parent whose transform was changed
+ * \brief Called once at the end of a frame in which a parent's transform was changed,
+ * if this entity's own transform wasn't. Covers moving, rotating and scaling.
+ * \param parent std::shared_ptr<GameEntity> The nearest parent whose transform was changed
  */
 void IComponent::OnParentTransform(std::shared_ptr<GameEntity> parent)
 {
 }
 
 /**
- * \brief Called when a parent is moved
+ * \brief No longer sent by the engine, parent changes are coalesced into OnParentTransform
  * \param parent std::shared_ptr<GameEntity> The parent who moved
  */
 void IComponent::OnParentMove(std::shared_ptr<GameEntity> parent)
@@ -198,7 +213,7 @@ void IComponent::OnParentMove(std::shared_ptr<GameEntity> parent)
 }
 
 /**
- * \brief Called when a parent is rotated
+ * \brief No longer sent by the engine, parent changes are coalesced into OnParentTransform
  * \param parent std::shared_ptr<GameEntity> The parent who rotated
  */
 void IComponent::OnParentRotate(std::shared_ptr<GameEntity> parent)
@@ -206,7 +221,7 @@ void IComponent::OnParentRotate(std::shared_ptr<GameEntity> parent)
 }
 
 /**
- * \brief Called when a parent is scaled
+ * \brief No longer sent by the engine, parent changes are coalesced into OnParentTransform
  * \param parent std::shared_ptr<GameEntity> The parent who scaled
  */
 void IComponent::OnParentScale(std::shared_ptr<GameEntity> parent)
@@ -262,12 +277,14 @@ void IComponent::OnAudioEnd(AudioEventPacket audio)
 /**
  * \brief 
  * \param gameEntity The GameEntity to be attached to
- * \param hierarchyIsEnabled If that GameEntity is enabled
+ * \param start Whether to call Start now, batch instantiation calls it later for every component at once
  */
-void IComponent::Bind(std::shared_ptr<GameEntity> gameEntity)
+void IComponent::Bind(std::shared_ptr<GameEntity> gameEntity, bool start)
 {
 	this->gameEntity = gameEntity;
-	Start();
+	if (gameEntity != nullptr)
+		gameEntity->boundComponents.push_back(this);
+	if (start) Start();
 }
 
 /**
@@ -275,6 +292,10 @@ void IComponent::Bind(std::shared_ptr<GameEntity> gameEntity)
  */
 void IComponent::Free()
 {
+	if (gameEntity != nullptr) {
+		std::vector<IComponent*>& bound = gameEntity->boundComponents;
+		bound.erase(std::remove(bound.begin(), bound.end(), this), bound.end());
+	}
 	gameEntity = nullptr;
 }
 
@@ -302,11 +323,21 @@ void IComponent::SetEnabled(bool enabled)
 {
 	if (this->enabled != enabled) {
 		this->enabled = enabled;
+		RefreshEnabledState();
 		if (IsEnabled()) OnEnable(); 
 		else if(gameEntity->GetEnabled()) OnDisable();
 	}
 }
 
+/// <summary>
+/// Writes this component's current IsEnabled() state into its pool's enabled bitset
+/// </summary>
+void IComponent::RefreshEnabledState()
+{
+	if (enabledSet == nullptr) return;
+	enabledSet->Set(handle.GetIndex(), enabled && gameEntity != nullptr && gameEntity->GetEnabled());
+}
+
 /**
  * \return The GameEntity this is bound to
  */
@@ -323,3 +354,12 @@ std::shared_ptr<Transform> IComponent::GetTransform()
 {
 	return gameEntity->GetTransform();
 }
+
+/// <summary>
+/// The handle of the pool slot this component lives in
+/// </summary>
+/// <returns>A handle that stops resolving once this component is freed</returns>
+ComponentHandle IComponent::GetHandle()
+{
+	return handle;
+}
@@ -1,6 +1,7 @@
 #include "..\Headers\Light.h"
 #include "..\Headers\GameEntity.h"
 #include "..\Headers\ComponentManager.h"
+#include <algorithm>
 
 bool Light::lightArrayDirty = false;
 std::vector<LightData> Light::lightData = std::vector<LightData>();
@@ -30,10 +31,9 @@ LightData Light::GetData()
 LightData* Light::GetLightArray()
 {
 	if (lightArrayDirty) {
-		std::vector<std::shared_ptr<Light>> lights = ComponentManager::GetAll<Light>();
 		lightData.clear();
-		for (std::shared_ptr<Light> light : lights) {
-			lightData.push_back(light->GetData());
+		for (Light& light : ComponentManager::View<Light>()) {
+			lightData.push_back(light.GetData());
 		}
 		lightArrayDirty = false;
 	}
@@ -45,6 +45,15 @@ int Light::GetLightArrayCount()
 	return lightData.size();
 }
 
+/// <summary>
+/// How many more lights can be added before MAX_LIGHTS is reached.
+/// Counts the pool rather than the light array, which is only rebuilt when read.
+/// </summary>
+int Light::GetRoomForLights()
+{
+	return std::max<int>(0, MAX_LIGHTS - ComponentManager::ActiveCount<Light>());
+}
+
 /// <summary>
 /// Populates this light with default data
 /// </summary>
@@ -86,10 +95,6 @@ void Light::OnParentTransform(std::shared_ptr<GameEntity> parent)
 	MarkLightAndShadowsDirty();
 }
 
-void Light::OnParentMove(std::shared_ptr<GameEntity> parent) {
-	MarkLightAndShadowsDirty();
-}
-
 void Light::OnMove(DirectX::XMFLOAT3 delta) {
 	MarkLightAndShadowsDirty();
 }
@@ -1,6 +1,8 @@
 #include "../Headers/Material.h"
 #include "..\Headers\AssetManager.h"
 #include "../Headers/ComponentManager.h"
+#include "../Headers/RenderQueue.h"
+#include "../Headers/AssetNameIndex.h"
 
 #pragma region Material
 
@@ -33,7 +35,9 @@ std::string Material::GetName() {
 }
 
 void Material::SetName(std::string name) {
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<Material>::Notify();
 }
 
 DirectX::XMFLOAT4 Material::GetTint() {
@@ -108,7 +112,7 @@ void Material::SetTransparent(bool transparent) {
 		// If this is turning off transparency, disable refraction as well
 		if (!transparent) this->refractive = false;
 		this->transparent = transparent;
-		ComponentManager::Sort<MeshRenderer>();
+		RenderQueue::GetInstance().MarkDirty();
 	}
 }
 
@@ -210,12 +214,12 @@ void Material::SetTexture(std::shared_ptr<Texture> texture) {
 
 void Material::SetPixelShader(std::shared_ptr<SimplePixelShader> pix) {
 	this->pixShader = pix;
-	ComponentManager::Sort<MeshRenderer>();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 void Material::SetVertexShader(std::shared_ptr<SimpleVertexShader> vert) {
 	this->vertShader = vert;
-	ComponentManager::Sort<MeshRenderer>();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 void Material::SetRefractivePixelShader(std::shared_ptr<SimplePixelShader> refractPix) {
@@ -385,12 +389,12 @@ void DX12Material::SetPipelineState(Microsoft::WRL::ComPtr<ID3D12PipelineState>
 
 void DX12Material::SetPixelShader(std::shared_ptr<SimplePixelShader> pix) {
 	this->pixShader = pix;
-	ComponentManager::Sort<MeshRenderer>();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 void DX12Material::SetVertexShader(std::shared_ptr<SimpleVertexShader> vert) {
 	this->vertShader = vert;
-	ComponentManager::Sort<MeshRenderer>();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 void DX12Material::SetRefractivePixelShader(std::shared_ptr<SimplePixelShader> refractPix) {
@@ -437,7 +441,9 @@ std::string TerrainMaterial::GetName() {
 }
 
 void TerrainMaterial::SetName(std::string name) {
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<TerrainMaterial>::Notify();
 }
 
 void TerrainMaterial::AddMaterial(std::shared_ptr<Material> materialToAdd) {
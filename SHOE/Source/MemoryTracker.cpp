@@ -0,0 +1,324 @@
+#include "..\Headers\MemoryTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "rapidjson\filewritestream.h"
+#include "rapidjson\prettywriter.h"
+
+namespace {
+	struct CategoryCounters
+	{
+		std::atomic<size_t> liveBytes;
+		std::atomic<size_t> peakBytes;
+		std::atomic<size_t> totalAllocations;
+		std::atomic<size_t> frameAllocations;
+		std::atomic<size_t> frameBytes;
+		std::atomic<size_t> lastFrameAllocations;
+		std::atomic<size_t> lastFrameBytes;
+	};
+
+#if SHOE_MEMORY_TRACKING
+	// Written before every tracked allocation. 16 bytes, so plain
+	// allocations keep malloc's 16 byte alignment.
+	struct AllocationHeader
+	{
+		size_t size;
+		uint32_t category;
+		// Distance from the start of the malloc block to the caller's pointer
+		uint32_t offset;
+	};
+	static_assert(sizeof(AllocationHeader) == 16, "AllocationHeader must stay 16 bytes");
+#endif
+
+	// Zero initialized before any constructor runs, so allocations
+	// made during static initialization are counted safely
+	CategoryCounters counters[MEMORY_CATEGORY_COUNT];
+	thread_local MemoryCategory currentCategory = MEMORY_UNTAGGED;
+
+	const char* categoryNames[MEMORY_CATEGORY_COUNT] = {
+		"Untagged",
+		"Component Pools",
+		"Meshes",
+		"Height Maps",
+		"Textures",
+		"Scene Data"
+	};
+
+	// Adds to a category's bytes without counting an allocation,
+	// for memory that grows in place like an external pool
+	void ChargeBytes(MemoryCategory category, size_t bytes)
+	{
+		CategoryCounters& counter = counters[category];
+		size_t live = counter.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		counter.frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+		size_t peak = counter.peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !counter.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+	}
+
+	void Refund(MemoryCategory category, size_t bytes)
+	{
+		counters[category].liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+
+#if SHOE_MEMORY_TRACKING
+	void Charge(MemoryCategory category, size_t bytes)
+	{
+		CategoryCounters& counter = counters[category];
+		counter.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+		counter.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+		ChargeBytes(category, bytes);
+	}
+
+	void* TrackedAllocate(size_t size, size_t alignment)
+	{
+		if (alignment < alignof(AllocationHeader)) alignment = alignof(AllocationHeader);
+		if (size > SIZE_MAX - sizeof(AllocationHeader) - alignment) return nullptr;
+
+		unsigned char* block = static_cast<unsigned char*>(std::malloc(size + sizeof(AllocationHeader) + alignment - alignof(AllocationHeader)));
+		if (block == nullptr) return nullptr;
+
+		uintptr_t user = ((uintptr_t)block + sizeof(AllocationHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+		header->size = size;
+		header->category = currentCategory;
+		header->offset = (uint32_t)(user - (uintptr_t)block);
+
+		Charge(currentCategory, size);
+		return reinterpret_cast<void*>(user);
+	}
+
+	void TrackedFree(void* pointer)
+	{
+		if (pointer == nullptr) return;
+
+		AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+		Refund((MemoryCategory)header->category, header->size);
+		std::free(static_cast<unsigned char*>(pointer) - header->offset);
+	}
+
+	// As the standard operator new does, keeps calling the new handler while
+	// allocation fails, since it may free memory, and throws once there is none
+	void* TrackedNew(size_t size, size_t alignment)
+	{
+		while (true) {
+			void* pointer = TrackedAllocate(size, alignment);
+			if (pointer != nullptr) return pointer;
+
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr) throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void* TrackedNewNoThrow(size_t size, size_t alignment) noexcept
+	{
+		try {
+			return TrackedNew(size, alignment);
+		}
+		catch (const std::bad_alloc&) {
+			return nullptr;
+		}
+	}
+#endif
+}
+
+#if SHOE_MEMORY_TRACKING
+#pragma region Global Allocation Hooks
+void* operator new(size_t size) { return TrackedNew(size, alignof(AllocationHeader)); }
+void* operator new[](size_t size) { return TrackedNew(size, alignof(AllocationHeader)); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedNew(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedNew(size, (size_t)alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, alignof(AllocationHeader)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, alignof(AllocationHeader)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, (size_t)alignment); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+#pragma endregion
+#endif
+
+std::vector<MemoryTracker::PoolEntry> MemoryTracker::pools = std::vector<MemoryTracker::PoolEntry>();
+
+const char* MemoryTracker::GetCategoryName(MemoryCategory category)
+{
+	return categoryNames[category];
+}
+
+/// <summary>
+/// Live and peak bytes for a category, plus allocation counts for the last completed frame
+/// </summary>
+MemoryCategoryStats MemoryTracker::GetStats(MemoryCategory category)
+{
+	CategoryCounters& counter = counters[category];
+	return {
+		counter.liveBytes.load(std::memory_order_relaxed),
+		counter.peakBytes.load(std::memory_order_relaxed),
+		counter.totalAllocations.load(std::memory_order_relaxed),
+		counter.lastFrameAllocations.load(std::memory_order_relaxed),
+		counter.lastFrameBytes.load(std::memory_order_relaxed)
+	};
+}
+
+MemoryCategory MemoryTracker::GetCurrentCategory()
+{
+	return currentCategory;
+}
+
+/// <summary>
+/// Closes out the per-frame allocation counts. Call once per frame.
+/// </summary>
+void MemoryTracker::EndFrame()
+{
+	for (CategoryCounters& counter : counters) {
+		counter.lastFrameAllocations.store(counter.frameAllocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		counter.lastFrameBytes.store(counter.frameBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+/// <summary>
+/// Adds a component pool to the slot count report.
+/// Called once per type by ComponentPool.
+/// </summary>
+/// <param name="name">Display name of the pool</param>
+/// <param name="slotSize">Bytes per component</param>
+/// <param name="getCapacity">Returns how many slots the pool has</param>
+/// <param name="getFreeCount">Returns how many of those are unbound</param>
+void MemoryTracker::RegisterPool(const char* name, size_t slotSize, uint32_t (*getCapacity)(), uint32_t (*getFreeCount)())
+{
+	pools.push_back({ name, slotSize, getCapacity, getFreeCount });
+}
+
+std::vector<MemoryPoolStats> MemoryTracker::GetPoolStats()
+{
+	std::vector<MemoryPoolStats> stats = std::vector<MemoryPoolStats>();
+	stats.reserve(pools.size());
+	for (PoolEntry& pool : pools) {
+		uint32_t freeSlots = pool.getFreeCount();
+		stats.push_back({ pool.name, pool.slotSize, pool.getCapacity() - freeSlots, freeSlots });
+	}
+	return stats;
+}
+
+/// <summary>
+/// Charges memory that didn't come from operator new to a category.
+/// Only the bytes are counted, not an allocation, since external memory
+/// is reported as it grows rather than per allocation.
+/// </summary>
+void MemoryTracker::TrackExternal(MemoryCategory category, size_t bytes)
+{
+	ChargeBytes(category, bytes);
+}
+
+/// <summary>
+/// Releases memory previously reported through TrackExternal
+/// </summary>
+void MemoryTracker::UntrackExternal(MemoryCategory category, size_t bytes)
+{
+	Refund(category, bytes);
+}
+
+/// <summary>
+/// Writes every category's stats and every pool's slot counts to a JSON file
+/// </summary>
+/// <param name="filepath">Full path of the file to write</param>
+/// <returns>Whether the file could be opened</returns>
+bool MemoryTracker::DumpToJSON(std::string filepath)
+{
+	FILE* file;
+	fopen_s(&file, filepath.c_str(), "w");
+	if (file == NULL) return false;
+
+	char writeBuffer[4096];
+	rapidjson::FileWriteStream stream(file, writeBuffer, sizeof(writeBuffer));
+	rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(stream);
+
+	writer.StartObject();
+
+	writer.Key("categories");
+	writer.StartArray();
+	for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+		MemoryCategoryStats stats = GetStats((MemoryCategory)i);
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(GetCategoryName((MemoryCategory)i));
+		writer.Key("liveBytes");
+		writer.Uint64(stats.liveBytes);
+		writer.Key("peakBytes");
+		writer.Uint64(stats.peakBytes);
+		writer.Key("totalAllocations");
+		writer.Uint64(stats.totalAllocations);
+		writer.Key("frameAllocations");
+		writer.Uint64(stats.frameAllocations);
+		writer.Key("frameBytes");
+		writer.Uint64(stats.frameBytes);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("pools");
+	writer.StartArray();
+	for (MemoryPoolStats& pool : GetPoolStats()) {
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(pool.name.c_str());
+		writer.Key("slotSize");
+		writer.Uint64(pool.slotSize);
+		writer.Key("liveSlots");
+		writer.Uint(pool.liveSlots);
+		writer.Key("freeSlots");
+		writer.Uint(pool.freeSlots);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.EndObject();
+	stream.Flush();
+
+	fclose(file);
+	return true;
+}
+
+MemoryScope::MemoryScope(MemoryCategory category)
+{
+	previous = currentCategory;
+	currentCategory = category;
+}
+
+MemoryScope::~MemoryScope()
+{
+	currentCategory = previous;
+}
+
+MemoryExternalAllocation::MemoryExternalAllocation(MemoryCategory category)
+{
+	this->category = category;
+	this->bytes = 0;
+}
+
+MemoryExternalAllocation::~MemoryExternalAllocation()
+{
+	SetSize(0);
+}
+
+/// <summary>
+/// Updates the reported size, charging or refunding the difference
+/// </summary>
+void MemoryExternalAllocation::SetSize(size_t bytes)
+{
+	if (bytes > this->bytes) MemoryTracker::TrackExternal(category, bytes - this->bytes);
+	else if (bytes < this->bytes) MemoryTracker::UntrackExternal(category, this->bytes - bytes);
+	this->bytes = bytes;
+}
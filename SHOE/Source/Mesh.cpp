@@ -1,4 +1,6 @@
 #include "../Headers/Mesh.h"
+#include "../Headers/AssetNameIndex.h"
+#include "../Headers/MemoryTracker.h"
 
 using namespace DirectX;
 
@@ -8,6 +10,7 @@ Mesh::~Mesh() {
 }
 
 Mesh::Mesh(Vertex* vertexArray, int vertices, unsigned int* indices, int indexCount, Microsoft::WRL::ComPtr<ID3D11Device> device, std::string name) {
+	MemoryScope memoryScope(MEMORY_MESHES);
 	this->vertexArray = new Vertex[vertices];
 	this->indices = new unsigned int[indexCount];
 	this->indexCount = indexCount;
@@ -27,6 +30,7 @@ Mesh::Mesh(Vertex* vertexArray, int vertices, unsigned int* indices, int indexCo
 }
 
 Mesh::Mesh(Vertex* vertexArray, int vertices, unsigned int* indices, int indexCount, int associatedMaterialIndex, Microsoft::WRL::ComPtr<ID3D11Device> device, std::string name) {
+	MemoryScope memoryScope(MEMORY_MESHES);
 	this->vertexArray = new Vertex[vertices];
 	this->indices = new unsigned int[indexCount];
 	this->indexCount = indexCount;
@@ -458,7 +462,9 @@ std::string Mesh::GetName() {
 }
 
 void Mesh::SetName(std::string name) {
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<Mesh>::Notify();
 }
 
 std::string Mesh::GetFileNameKey() {
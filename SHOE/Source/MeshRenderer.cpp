@@ -1,5 +1,6 @@
 #include "../Headers/MeshRenderer.h"
 #include "..\Headers\AssetManager.h"
+#include "..\Headers\RenderQueue.h"
 
 std::shared_ptr<Mesh> MeshRenderer::defaultMesh = nullptr;
 std::shared_ptr<Material> MeshRenderer::defaultMat = nullptr;
@@ -33,16 +34,7 @@ void MeshRenderer::OnDestroy()
 {
 	mesh = nullptr;
 	mat = nullptr;
-}
-
-void MeshRenderer::OnTransform()
-{
-	CalculateBounds();
-}
-
-void MeshRenderer::OnParentTransform(std::shared_ptr<GameEntity> parent)
-{
-	CalculateBounds();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 /// <summary>
@@ -68,6 +60,7 @@ std::shared_ptr<Material> MeshRenderer::GetMaterial() {
 void MeshRenderer::SetMesh(std::shared_ptr<Mesh> newMesh) {
 	this->mesh = newMesh;
 	CalculateBounds();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
 /// <summary>
@@ -76,16 +69,22 @@ void MeshRenderer::SetMesh(std::shared_ptr<Mesh> newMesh) {
 /// <param name="newMesh">New material to render</param>
 void MeshRenderer::SetMaterial(std::shared_ptr<Material> newMaterial) {
 	this->mat = newMaterial;
-	ComponentManager::Sort<MeshRenderer>();
+	RenderQueue::GetInstance().MarkDirty();
 }
 
+/// <summary>
+/// Get the world space bounds of the mesh, recalculated here if the
+/// transform has moved since, whether by itself or with a parent
+/// </summary>
 DirectX::BoundingOrientedBox MeshRenderer::GetBounds()
 {
+	if (GetTransform()->WorldChangedSince(boundsVersion)) CalculateBounds();
 	return bounds;
 }
 
 void MeshRenderer::CalculateBounds()
 {
+	boundsVersion = GetTransform()->GetWorldVersion();
 	bounds = DirectX::BoundingOrientedBox(mesh->GetBounds());
 	bounds.Transform(bounds, DirectX::XMLoadFloat4x4(&GetTransform()->GetWorldMatrix()));
 }
@@ -0,0 +1,39 @@
+#include "..\Headers\Prefab.h"
+
+Prefab::Prefab(std::string name)
+{
+	this->name = name;
+	this->enabled = true;
+	this->components = std::vector<std::function<void(const std::vector<std::shared_ptr<GameEntity>>&)>>();
+}
+
+Prefab::~Prefab()
+{
+	components.clear();
+}
+
+std::string Prefab::GetName()
+{
+	return name;
+}
+
+/// <summary>
+/// Sets the name every instance is created with
+/// </summary>
+void Prefab::SetName(std::string name)
+{
+	this->name = name;
+}
+
+bool Prefab::GetEnabled()
+{
+	return enabled;
+}
+
+/// <summary>
+/// Sets whether instances start out enabled
+/// </summary>
+void Prefab::SetEnabled(bool enabled)
+{
+	this->enabled = enabled;
+}
@@ -0,0 +1,330 @@
+#include "..\Headers\RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include "..\Headers\ComponentManager.h"
+#include "..\Headers\Light.h"
+#include "..\Headers\Terrain.h"
+#include "..\Headers\Time.h"
+#include "..\Headers\Transform.h"
+
+// Singleton requirement
+RenderQueue* RenderQueue::instance;
+
+RenderQueue::RenderQueue()
+{
+	dirty = true;
+	opaqueCount = 0;
+	entries = std::vector<RenderQueueEntry>();
+	sortScratch = std::vector<RenderQueueEntry>();
+	order = std::vector<uint32_t>();
+	captureTransforms = std::vector<Transform*>();
+	captureMeshes = std::unordered_map<const Mesh*, uint32_t>();
+	captureMaterials = std::unordered_map<const Material*, uint32_t>();
+}
+
+RenderQueue::~RenderQueue()
+{
+	entries.clear();
+	sortScratch.clear();
+	order.clear();
+	captureTransforms.clear();
+	captureMeshes.clear();
+	captureMaterials.clear();
+}
+
+/// <summary>
+/// Flags the draw order as stale. Call whenever a MeshRenderer is added or removed,
+/// or its mesh, material, or any material state in the sort key changes.
+/// </summary>
+void RenderQueue::MarkDirty()
+{
+	dirty = true;
+}
+
+bool RenderQueue::IsDirty()
+{
+	return dirty;
+}
+
+/// <summary>
+/// Rebuilds and sorts the keys if anything was marked dirty since the last call.
+/// Meant to be called once per frame before drawing.
+/// </summary>
+void RenderQueue::Update()
+{
+	if (!dirty) return;
+
+	vertexShaderGroups.clear();
+	pixelShaderGroups.clear();
+	materialGroups.clear();
+	meshGroups.clear();
+
+	entries.clear();
+	for (MeshRenderer& meshRenderer : ComponentManager::View<MeshRenderer>()) {
+		entries.push_back({ MakeKey(meshRenderer), meshRenderer.GetHandle().GetIndex() });
+	}
+
+	RadixSort();
+
+	order.resize(entries.size());
+	opaqueCount = entries.size();
+	for (size_t i = 0; i < entries.size(); i++) {
+		order[i] = entries[i].slot;
+		if (opaqueCount == entries.size() && (entries[i].key >> RENDER_KEY_TRANSPARENT_SHIFT) != 0) {
+			opaqueCount = i;
+		}
+	}
+
+	dirty = false;
+}
+
+/// <summary>
+/// Enabled MeshRenderers in sorted draw order, opaque first
+/// </summary>
+ComponentView<MeshRenderer> RenderQueue::GetView()
+{
+	return ComponentManager::ViewEnabled<MeshRenderer>(&order);
+}
+
+/// <summary>
+/// Position in the view of the first transparent MeshRenderer
+/// </summary>
+size_t RenderQueue::GetOpaqueCount()
+{
+	return opaqueCount;
+}
+
+const std::vector<RenderQueueEntry>& RenderQueue::GetEntries()
+{
+	return entries;
+}
+
+/// <summary>
+/// Copies everything drawing reads from the scene into a snapshot: each enabled
+/// MeshRenderer's matrices and bounds in draw order, the buffers of the meshes and
+/// the shaders, textures and constants of the materials they use, the lights and
+/// their shadow projectors, and the enabled terrains.
+/// Call once a frame after everything has moved, so the renderer can draw the
+/// snapshot while the next frame changes the scene.
+/// </summary>
+/// <param name="snapshot">Snapshot to overwrite</param>
+void RenderQueue::Capture(RenderSnapshot& snapshot)
+{
+	Update();
+
+	snapshot.Clear();
+	snapshot.frame = Time::frameCount;
+	snapshot.time = Time::totalTime;
+	captureMeshes.clear();
+	captureMaterials.clear();
+
+	ComponentView<MeshRenderer> view = GetView();
+
+	// Work out every normal matrix the snapshot needs in one batch
+	captureTransforms.clear();
+	for (size_t i = 0; i < view.size(); i++) {
+		if (view.Includes(i)) captureTransforms.push_back(view[i].GetTransform().get());
+	}
+	TransformHierarchy::UpdateInverseTransposes(captureTransforms);
+
+	snapshot.items.reserve(captureTransforms.size());
+	for (size_t i = 0; i < view.size(); i++) {
+		if (!view.Includes(i)) continue;
+
+		MeshRenderer& meshRenderer = view[i];
+		std::shared_ptr<Transform> transform = meshRenderer.GetTransform();
+
+		RenderSnapshotItem item;
+		item.meshRenderer = meshRenderer.GetHandle();
+		item.mesh = CaptureMesh(snapshot, meshRenderer.GetMesh().get());
+		item.material = CaptureMaterial(snapshot, meshRenderer.GetMaterial().get());
+		item.sortKey = entries[i].key;
+		item.world = transform->GetWorldMatrix();
+		item.worldInverseTranspose = transform->GetWorldInverseTransposeMatrix();
+		item.position = transform->GetGlobalPosition();
+		item.rotation = transform->GetGlobalRotation();
+		item.scale = transform->GetGlobalScale();
+		item.bounds = meshRenderer.GetBounds();
+		snapshot.items.push_back(item);
+
+		if (i < opaqueCount) snapshot.opaqueCount++;
+	}
+
+	// Rebuilds the light array if any light changed
+	LightData* lights = Light::GetLightArray();
+	snapshot.lightCount = std::min<unsigned int>(Light::GetLightArrayCount(), MAX_LIGHTS);
+	memcpy(snapshot.lights, lights, sizeof(LightData) * snapshot.lightCount);
+
+	CaptureLights(snapshot);
+	CaptureTerrains(snapshot);
+}
+
+/// <summary>
+/// Position of a mesh's buffers in the snapshot, adding them the first time it's seen
+/// </summary>
+uint32_t RenderQueue::CaptureMesh(RenderSnapshot& snapshot, Mesh* mesh)
+{
+	auto found = captureMeshes.try_emplace(mesh, (uint32_t)snapshot.meshes.size());
+	if (!found.second) return found.first->second;
+
+	RenderSnapshotMesh captured;
+	captured.vertexBuffer = mesh->GetVertexBuffer();
+	captured.indexBuffer = mesh->GetIndexBuffer();
+	captured.indexCount = (unsigned int)mesh->GetIndexCount();
+	snapshot.meshes.push_back(std::move(captured));
+	return found.first->second;
+}
+
+/// <summary>
+/// Position of a material's state in the snapshot, copying it the first time it's seen
+/// </summary>
+uint32_t RenderQueue::CaptureMaterial(RenderSnapshot& snapshot, Material* material)
+{
+	auto found = captureMaterials.try_emplace(material, (uint32_t)snapshot.materials.size());
+	if (!found.second) return found.first->second;
+
+	RenderSnapshotMaterial captured;
+	captured.vertexShader = material->GetVertShader();
+	captured.pixelShader = material->GetPixShader();
+	captured.refractivePixelShader = material->GetRefractivePixelShader();
+
+	// Only DX11 materials have samplers and textures to draw with
+	if (DX11Material* dx11Material = dynamic_cast<DX11Material*>(material)) {
+		captured.sampler = dx11Material->GetSamplerState();
+		captured.clampSampler = dx11Material->GetClampSamplerState();
+		if (std::shared_ptr<Texture> texture = dx11Material->GetTexture()) captured.albedo = texture->GetDX11Texture();
+		if (std::shared_ptr<Texture> texture = dx11Material->GetNormalMap()) captured.normal = texture->GetDX11Texture();
+		if (std::shared_ptr<Texture> texture = dx11Material->GetMetalMap()) captured.metal = texture->GetDX11Texture();
+		if (std::shared_ptr<Texture> texture = dx11Material->GetRoughMap()) captured.rough = texture->GetDX11Texture();
+	}
+
+	captured.tint = material->GetTint();
+	captured.tiling = material->GetTiling();
+	captured.indexOfRefraction = material->GetIndexOfRefraction();
+	captured.refractionScale = material->GetRefractionScale();
+	captured.refractive = material->GetRefractive();
+	snapshot.materials.push_back(std::move(captured));
+	return found.first->second;
+}
+
+/// <summary>
+/// Copies the shadow projectors of enabled shadow casting lights, and the
+/// point lights' gizmos
+/// </summary>
+void RenderQueue::CaptureLights(RenderSnapshot& snapshot)
+{
+	for (Light& light : ComponentManager::ViewEnabled<Light>()) {
+		if (light.GetType() == 1.0f) {
+			RenderSnapshotPointLight pointLight;
+			pointLight.world = light.GetTransform()->GetWorldMatrix();
+			pointLight.color = light.GetColor();
+			pointLight.color.x *= light.GetIntensity();
+			pointLight.color.y *= light.GetIntensity();
+			pointLight.color.z *= light.GetIntensity();
+			snapshot.pointLights.push_back(pointLight);
+		}
+
+		if (!light.CastsShadows()) continue;
+
+		std::shared_ptr<ShadowProjector> projector = light.GetShadowProjector();
+
+		RenderSnapshotShadow shadow;
+		shadow.depthStencil = projector->GetDSV();
+		shadow.view = projector->GetViewMatrix();
+		shadow.projection = projector->GetProjectionMatrix();
+		shadow.width = projector->GetProjectionWidth();
+		shadow.height = projector->GetProjectionHeight();
+		snapshot.shadows.push_back(std::move(shadow));
+	}
+}
+
+/// <summary>
+/// Copies each enabled terrain's mesh, matrix, shaders and layer textures
+/// </summary>
+void RenderQueue::CaptureTerrains(RenderSnapshot& snapshot)
+{
+	for (Terrain& terrain : ComponentManager::ViewEnabled<Terrain>()) {
+		std::shared_ptr<TerrainMaterial> terrainMaterial = terrain.GetMaterial();
+
+		// Only DX11 terrain materials have a blend map to draw with
+		DX11TerrainMaterial* dx11TerrainMaterial = dynamic_cast<DX11TerrainMaterial*>(terrainMaterial.get());
+		if (dx11TerrainMaterial == nullptr) continue;
+
+		RenderSnapshotTerrain captured;
+		captured.world = terrain.GetTransform()->GetWorldMatrix();
+		captured.mesh = CaptureMesh(snapshot, terrain.GetMesh().get());
+		captured.vertexShader = terrainMaterial->GetVertexShader();
+		captured.pixelShader = terrainMaterial->GetPixelShader();
+		captured.blendMap = dx11TerrainMaterial->GetBlendMap();
+		captured.firstTexture = (uint32_t)snapshot.terrainTextures.size();
+		captured.layerCount = (uint32_t)terrainMaterial->GetMaterialCount();
+
+		for (uint32_t i = 0; i < captured.layerCount; i++) {
+			DX11Material* layer = dynamic_cast<DX11Material*>(terrainMaterial->GetMaterialAtID(i).get());
+			if (i == 0) captured.clampSampler = layer->GetClampSamplerState();
+
+			snapshot.terrainTextures.push_back(layer->GetTexture()->GetDX11Texture());
+			snapshot.terrainTextures.push_back(layer->GetNormalMap()->GetDX11Texture());
+			snapshot.terrainTextures.push_back(layer->GetRoughMap()->GetDX11Texture());
+			snapshot.terrainTextures.push_back(layer->GetMetalMap()->GetDX11Texture());
+		}
+
+		snapshot.terrains.push_back(std::move(captured));
+	}
+}
+
+uint64_t RenderQueue::MakeKey(MeshRenderer& meshRenderer)
+{
+	Material* material = meshRenderer.GetMaterial().get();
+
+	uint64_t key = (uint64_t)GetGroupID(meshGroups, meshRenderer.GetMesh().get(), RENDER_KEY_MESH_BITS);
+	key |= (uint64_t)GetGroupID(materialGroups, material, RENDER_KEY_MATERIAL_BITS) << RENDER_KEY_MATERIAL_SHIFT;
+	key |= (uint64_t)GetGroupID(pixelShaderGroups, material->GetPixShader().get(), RENDER_KEY_PIXEL_SHADER_BITS) << RENDER_KEY_PIXEL_SHADER_SHIFT;
+	key |= (uint64_t)GetGroupID(vertexShaderGroups, material->GetVertShader().get(), RENDER_KEY_VERTEX_SHADER_BITS) << RENDER_KEY_VERTEX_SHADER_SHIFT;
+	key |= (uint64_t)material->GetTransparent() << RENDER_KEY_TRANSPARENT_SHIFT;
+	return key;
+}
+
+/// <summary>
+/// Maps a resource pointer to a small ID that fits in its key field.
+/// Once a field runs out of IDs, further resources share the last one,
+/// which only costs some grouping, never correctness.
+/// </summary>
+uint32_t RenderQueue::GetGroupID(std::unordered_map<const void*, uint32_t>& groups, const void* resource, uint32_t bits)
+{
+	uint32_t maxID = (1u << bits) - 1;
+	auto found = groups.try_emplace(resource, (uint32_t)groups.size());
+	return found.first->second < maxID ? found.first->second : maxID;
+}
+
+/// <summary>
+/// Stable LSD radix sort on the keys, one byte per pass.
+/// Passes where every key shares the same byte are skipped, which with
+/// dense group IDs is usually most of the upper bytes.
+/// </summary>
+void RenderQueue::RadixSort()
+{
+	size_t count = entries.size();
+	if (count < 2) return;
+
+	sortScratch.resize(count);
+	for (uint32_t shift = 0; shift < 64; shift += 8) {
+		size_t histogram[256] = {};
+		for (const RenderQueueEntry& entry : entries) {
+			histogram[(entry.key >> shift) & 0xFF]++;
+		}
+		if (histogram[(entries[0].key >> shift) & 0xFF] == count) continue;
+
+		size_t offset = 0;
+		for (size_t& bucket : histogram) {
+			size_t size = bucket;
+			bucket = offset;
+			offset += size;
+		}
+		for (const RenderQueueEntry& entry : entries) {
+			sortScratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+		}
+		entries.swap(sortScratch);
+	}
+}
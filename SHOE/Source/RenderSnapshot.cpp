@@ -0,0 +1,203 @@
+#include "..\Headers\RenderSnapshot.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+// Singleton requirement
+RenderSnapshotBuffer* RenderSnapshotBuffer::instance;
+
+/// <summary>
+/// Empties the snapshot, keeping its item storage for reuse
+/// </summary>
+void RenderSnapshot::Clear()
+{
+	frame = 0;
+	time = 0.0f;
+	items.clear();
+	opaqueCount = 0;
+	meshes.clear();
+	materials.clear();
+	lightCount = 0;
+	shadows.clear();
+	pointLights.clear();
+	terrains.clear();
+	terrainTextures.clear();
+}
+
+RenderSnapshotBuffer::RenderSnapshotBuffer()
+{
+	for (RenderSnapshot& snapshot : snapshots) {
+		snapshot.items = std::vector<RenderSnapshotItem>();
+		snapshot.Clear();
+	}
+	interpolated.items = std::vector<RenderSnapshotItem>();
+	interpolated.Clear();
+	previousItems = std::vector<uint32_t>();
+	interpolationDelay = 0.0f;
+
+	writeSlot = 0;
+	publishedSlot = NoSlot;
+	currentSlot = 1;
+	previousSlot = 2;
+}
+
+RenderSnapshotBuffer::~RenderSnapshotBuffer()
+{
+	for (RenderSnapshot& snapshot : snapshots) {
+		snapshot.items.clear();
+	}
+	interpolated.items.clear();
+	previousItems.clear();
+}
+
+/// <summary>
+/// The snapshot the simulation fills before calling Publish.
+/// The renderer never reads it until then.
+/// </summary>
+RenderSnapshot& RenderSnapshotBuffer::GetWriteSnapshot()
+{
+	return snapshots[writeSlot];
+}
+
+/// <summary>
+/// Makes the write snapshot the newest for the renderer, and moves writing to a free slot.
+/// If the renderer never picked up the last one published, that one is written over next.
+/// </summary>
+void RenderSnapshotBuffer::Publish()
+{
+	std::lock_guard<std::mutex> lock(slotMutex);
+
+	if (publishedSlot != NoSlot) {
+		std::swap(writeSlot, publishedSlot);
+		return;
+	}
+
+	publishedSlot = writeSlot;
+	for (int slot = 0; slot < SlotCount; slot++) {
+		if (slot != publishedSlot && slot != currentSlot && slot != previousSlot) {
+			writeSlot = slot;
+			break;
+		}
+	}
+}
+
+/// <summary>
+/// Takes the newest published snapshot as current, and the old current as previous.
+/// Call once before each draw.
+/// </summary>
+/// <returns>False if nothing new was published, in which case both are kept</returns>
+bool RenderSnapshotBuffer::Acquire()
+{
+	std::lock_guard<std::mutex> lock(slotMutex);
+
+	if (publishedSlot == NoSlot) return false;
+
+	previousSlot = currentSlot;
+	currentSlot = publishedSlot;
+	publishedSlot = NoSlot;
+	return true;
+}
+
+/// <summary>
+/// The snapshot taken by the last Acquire. Render side only.
+/// </summary>
+const RenderSnapshot& RenderSnapshotBuffer::GetCurrent()
+{
+	return snapshots[currentSlot];
+}
+
+/// <summary>
+/// The snapshot current before the last Acquire. Render side only.
+/// </summary>
+const RenderSnapshot& RenderSnapshotBuffer::GetPrevious()
+{
+	return snapshots[previousSlot];
+}
+
+/// <summary>
+/// Blends the previous snapshot into the current one, for drawing between
+/// simulation steps. Renderers in both have their world position and scale
+/// lerped and rotation slerped, and their matrices rebuilt from those, so
+/// any shear from non-uniformly scaled parents is lost part way.
+/// Renderers new in the current snapshot, and everything else, are taken as is.
+/// Render side only. The result is overwritten by the next call.
+/// </summary>
+/// <param name="alpha">0 for the previous snapshot, 1 for the current one</param>
+const RenderSnapshot& RenderSnapshotBuffer::GetInterpolated(float alpha)
+{
+	const RenderSnapshot& from = snapshots[previousSlot];
+	const RenderSnapshot& to = snapshots[currentSlot];
+	if (alpha >= 1.0f) return to;
+
+	// Everything but the items' transforms is the current snapshot's
+	interpolated = to;
+
+	// Index the previous snapshot's items by renderer slot
+	for (uint32_t i = 0; i < from.items.size(); i++) {
+		uint32_t slot = from.items[i].meshRenderer.GetIndex();
+		if (slot >= previousItems.size()) previousItems.resize(slot + 1, 0);
+		previousItems[slot] = i + 1;
+	}
+
+	for (RenderSnapshotItem& blended : interpolated.items) {
+		uint32_t slot = blended.meshRenderer.GetIndex();
+		if (slot >= previousItems.size() || previousItems[slot] == 0) continue;
+
+		// The slot may have been freed and reused in between
+		const RenderSnapshotItem& before = from.items[previousItems[slot] - 1];
+		if (before.meshRenderer != blended.meshRenderer) continue;
+
+		XMVECTOR position = XMVectorLerp(XMLoadFloat3(&before.position), XMLoadFloat3(&blended.position), alpha);
+		XMVECTOR rotation = XMQuaternionSlerp(XMLoadFloat4(&before.rotation), XMLoadFloat4(&blended.rotation), alpha);
+		XMVECTOR scale = XMVectorLerp(XMLoadFloat3(&before.scale), XMLoadFloat3(&blended.scale), alpha);
+
+		XMMATRIX world = XMMatrixAffineTransformation(scale, XMVectorZero(), rotation, position);
+		XMStoreFloat4x4(&blended.world, world);
+		XMStoreFloat4x4(&blended.worldInverseTranspose, XMMatrixTranspose(XMMatrixInverse(nullptr, world)));
+		XMStoreFloat3(&blended.position, position);
+		XMStoreFloat4(&blended.rotation, rotation);
+		XMStoreFloat3(&blended.scale, scale);
+
+		XMStoreFloat3(&blended.bounds.Center, XMVectorLerp(XMLoadFloat3(&before.bounds.Center), XMLoadFloat3(&blended.bounds.Center), alpha));
+		XMStoreFloat3(&blended.bounds.Extents, XMVectorLerp(XMLoadFloat3(&before.bounds.Extents), XMLoadFloat3(&blended.bounds.Extents), alpha));
+		XMStoreFloat4(&blended.bounds.Orientation, XMQuaternionSlerp(XMLoadFloat4(&before.bounds.Orientation), XMLoadFloat4(&blended.bounds.Orientation), alpha));
+	}
+
+	// Leave the index empty for next time
+	for (const RenderSnapshotItem& item : from.items) {
+		previousItems[item.meshRenderer.GetIndex()] = 0;
+	}
+
+	return interpolated;
+}
+
+/// <summary>
+/// How far a time lies from the previous snapshot's capture to the current one's,
+/// as the alpha for GetInterpolated. Render side only.
+/// </summary>
+/// <returns>Between 0 and 1, or 1 if the current snapshot isn't newer than the previous</returns>
+float RenderSnapshotBuffer::GetAlpha(float time)
+{
+	float from = snapshots[previousSlot].time;
+	float to = snapshots[currentSlot].time;
+	if (to <= from) return 1.0f;
+
+	return std::max<float>(0.0f, std::min<float>((time - from) / (to - from), 1.0f));
+}
+
+/// <summary>
+/// Sets how many seconds behind the newest snapshot the renderer draws.
+/// At 0 it draws the newest as is. Around a frame's length it blends the
+/// last two, which smooths motion when simulation and drawing run at
+/// different rates, at the cost of that much latency.
+/// </summary>
+void RenderSnapshotBuffer::SetInterpolationDelay(float delay)
+{
+	interpolationDelay = std::max<float>(delay, 0.0f);
+}
+
+float RenderSnapshotBuffer::GetInterpolationDelay()
+{
+	return interpolationDelay;
+}
@@ -1,6 +1,7 @@
 #include "../Headers/SceneManager.h"
 #include "..\Headers\NoclipMovement.h"
 #include "..\Headers\FlashlightController.h"
+#include "..\Headers\MemoryTracker.h"
 
 SceneManager* SceneManager::instance;
 
@@ -426,6 +427,8 @@ void SceneManager::LoadEntities(const rapidjson::Value& sceneDoc, std::function<
 	AssetPathType* pathType = new AssetPathType();
 	*pathType = ENGINE_ASSET;
 
+	ReserveComponents(entityBlock);
+
 	for (rapidjson::SizeType i = 0; i < entityBlock.Size(); i++) {
 		currentLoadName = entityBlock[i].FindMember(NAME)->value.GetString();
 		if(progressListener) progressListener("Entities");
@@ -531,6 +534,35 @@ void SceneManager::LoadEntities(const rapidjson::Value& sceneDoc, std::function<
 	delete pathType;
 }
 
+/// <summary>
+/// Counts every component in the scene by type and reserves pool space for
+/// all of them up front, so each pool grows once instead of a chunk at a time
+/// </summary>
+/// <param name="entityBlock">The scene's array of entities</param>
+void SceneManager::ReserveComponents(const rapidjson::Value& entityBlock)
+{
+	uint32_t counts[ComponentTypes::COMPONENT_TYPE_COUNT] = {};
+	for (rapidjson::SizeType i = 0; i < entityBlock.Size(); i++) {
+		const rapidjson::Value& componentBlock = entityBlock[i].FindMember(COMPONENTS)->value;
+		for (rapidjson::SizeType c = 0; c < componentBlock.Size(); c++) {
+			int componentType = componentBlock[c].FindMember(COMPONENT_TYPE)->value.GetInt();
+			if (componentType >= 0 && componentType < ComponentTypes::COMPONENT_TYPE_COUNT) counts[componentType]++;
+		}
+	}
+
+	// Every entity has a transform, and every collider has an offset transform
+	ComponentManager::Reserve<Transform>(entityBlock.Size() + counts[ComponentTypes::COLLIDER]);
+	ComponentManager::Reserve<MeshRenderer>(counts[ComponentTypes::MESH_RENDERER]);
+	ComponentManager::Reserve<ParticleSystem>(counts[ComponentTypes::PARTICLE_SYSTEM]);
+	ComponentManager::Reserve<Collider>(counts[ComponentTypes::COLLIDER]);
+	ComponentManager::Reserve<Terrain>(counts[ComponentTypes::TERRAIN]);
+	ComponentManager::Reserve<Light>(counts[ComponentTypes::LIGHT]);
+	ComponentManager::Reserve<Camera>(counts[ComponentTypes::CAMERA]);
+	ComponentManager::Reserve<NoclipMovement>(counts[ComponentTypes::NOCLIP_CHAR_CONTROLLER]);
+	ComponentManager::Reserve<FlashlightController>(counts[ComponentTypes::FLASHLIGHT_CONTROLLER]);
+	ComponentManager::Reserve<AudioResponse>(counts[ComponentTypes::AUDIO_RESPONSE_DEVICE]);
+}
+
 /// <summary>
 /// Saves the scene's assets
 /// </summary>
@@ -1001,6 +1033,9 @@ void SceneManager::LoadScene(std::string filepath, bool isFullPathToScene) {
 	*engineState = EngineState::LOAD_SCENE;
 
 	try {
+		MemoryScope memoryScope(MEMORY_SCENE_DATA);
+		// rapidjson allocates with malloc, so its document is reported by hand
+		MemoryExternalAllocation documentMemory(MEMORY_SCENE_DATA);
 		rapidjson::Document sceneDoc;
 
 		std::string namePath;
@@ -1022,6 +1057,7 @@ void SceneManager::LoadScene(std::string filepath, bool isFullPathToScene) {
 		rapidjson::FileReadStream sceneFileStream(file, readBuffer, sizeof(readBuffer));
 
 		sceneDoc.ParseStream(sceneFileStream);
+		documentMemory.SetSize(sceneDoc.GetAllocator().Capacity());
 
 		// Check if this is a valid SHOE scene
 		assert(sceneDoc[VALID_SHOE_SCENE].GetBool());
@@ -1076,6 +1112,8 @@ void SceneManager::SaveScene(std::string filepath, std::string sceneName, bool i
 		return;
 
 	try {
+		MemoryScope memoryScope(MEMORY_SCENE_DATA);
+		MemoryExternalAllocation documentMemory(MEMORY_SCENE_DATA);
 		char cbuf[4096];
 		rapidjson::MemoryPoolAllocator<> allocator(cbuf, sizeof(cbuf));
 
@@ -1094,6 +1132,7 @@ void SceneManager::SaveScene(std::string filepath, std::string sceneName, bool i
 		//
 		SaveAssets(sceneDocToSave);
 		SaveEntities(sceneDocToSave);
+		documentMemory.SetSize(allocator.Capacity());
 
 		// At the end of gathering data, write it all to the appropriate file
 		std::string namePath;
@@ -1165,6 +1204,8 @@ void SceneManager::PrePlaySave()
 		return;
 
 	try {
+		MemoryScope memoryScope(MEMORY_SCENE_DATA);
+		MemoryExternalAllocation documentMemory(MEMORY_SCENE_DATA);
 		char cbuf[4096];
 		rapidjson::MemoryPoolAllocator<> allocator(cbuf, sizeof(cbuf));
 
@@ -1177,6 +1218,7 @@ void SceneManager::PrePlaySave()
 		sceneDocToSave.AddMember(VALID_SHOE_SCENE, true, allocator);
 
 		SaveEntities(sceneDocToSave);
+		documentMemory.SetSize(allocator.Capacity());
 
 		// At the end of gathering data, write it all
 		// to the appropriate file
@@ -1213,6 +1255,8 @@ void SceneManager::PostPlayLoad()
 	try {
 		*engineState = EngineState::UNLOAD_PLAY;
 
+		MemoryScope memoryScope(MEMORY_SCENE_DATA);
+		MemoryExternalAllocation documentMemory(MEMORY_SCENE_DATA);
 		rapidjson::Document sceneDoc;
 
 		std::string namePath = assetManager.GetFullPathToEngineAsset(AssetPathIndex::ASSET_SCENE_PATH, ".temp_play_save.json");
@@ -1228,6 +1272,7 @@ void SceneManager::PostPlayLoad()
 		rapidjson::FileReadStream sceneFileStream(file, readBuffer, sizeof(readBuffer));
 
 		sceneDoc.ParseStream(sceneFileStream);
+		documentMemory.SetSize(sceneDoc.GetAllocator().Capacity());
 
 		// Check if this is a valid SHOE scene
 		assert(sceneDoc[VALID_SHOE_SCENE].GetBool());
@@ -1,4 +1,5 @@
 #include "../Headers/SimpleShader.h"
+#include "../Headers/AssetNameIndex.h"
 
 // Default error reporting state
 bool ISimpleShader::ReportErrors = false;
@@ -693,7 +694,9 @@ const SimpleConstantBuffer* ISimpleShader::GetBufferInfo(unsigned int index)
 }
 
 void ISimpleShader::SetName(std::string name) {
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<ISimpleShader>::Notify();
 }
 
 std::string ISimpleShader::GetFileNameKey() {
@@ -1,4 +1,5 @@
 #include "../Headers/Sky.h"
+#include "../Headers/AssetNameIndex.h"
 
 Sky::Sky(Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerOptions, 
 		 Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> skyTexture, 
@@ -349,7 +350,9 @@ std::string Sky::GetName() {
 }
 
 void Sky::SetName(std::string name) {
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<Sky>::Notify();
 }
 
 bool Sky::GetFilenameKeyType() {
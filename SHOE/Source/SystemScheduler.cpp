@@ -0,0 +1,259 @@
+#include "..\Headers\SystemScheduler.h"
+#include "..\Headers\EntityCommandBuffer.h"
+
+#include <algorithm>
+
+// Singleton requirement
+SystemScheduler* SystemScheduler::instance;
+
+SystemScheduler::SystemScheduler()
+{
+	systems = std::vector<ScheduledSystem>();
+	for (ComponentMask& mask : scheduledTypes) mask = 0;
+	wavesDirty = true;
+	deterministic = false;
+
+	workers = std::vector<std::thread>();
+	currentJob = nullptr;
+	jobCount = 0;
+	nextJob = 0;
+	remainingJobs = 0;
+	jobException = nullptr;
+	waveGeneration = 0;
+	shuttingDown = false;
+}
+
+SystemScheduler::~SystemScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		shuttingDown = true;
+	}
+	jobReady.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	systems.clear();
+}
+
+/// <summary>
+/// Adds a system to run every frame of the given phase.
+/// Must not be called from inside a running system.
+/// </summary>
+/// <param name="name">Label for debugging</param>
+/// <param name="phase">Update or EditingUpdate</param>
+/// <param name="reads">Component types the system only reads</param>
+/// <param name="writes">Component types the system may change</param>
+/// <param name="run">Called once per frame</param>
+void SystemScheduler::RegisterSystem(std::string name, EntityEventType phase, ComponentMask reads, ComponentMask writes, std::function<void()> run)
+{
+	systems.push_back({ name, phase, reads, writes, run });
+	wavesDirty = true;
+}
+
+/// <summary>
+/// Runs every system registered for a phase, waiting until all have finished
+/// </summary>
+/// <param name="phase">Update or EditingUpdate</param>
+void SystemScheduler::Run(EntityEventType phase)
+{
+	if (wavesDirty) BuildWaves();
+
+	EntityCommandBuffer::IterationScope iterating;
+	if (deterministic) {
+		for (ScheduledSystem& system : systems) {
+			if (system.phase == phase) system.run();
+		}
+		return;
+	}
+
+	for (const std::vector<size_t>& wave : waves[phase]) {
+		RunWave(wave);
+	}
+}
+
+/// <summary>
+/// Calls job once for each index below jobCount, spread over the worker pool
+/// and the calling thread, and returns once every call has finished.
+/// Starts a worker per extra hardware thread the first time it's needed.
+/// Call from the main thread, never from inside a system or another job.
+/// If a call throws, the first exception is rethrown once every call has finished.
+/// </summary>
+/// <param name="jobCount">How many times to call job</param>
+/// <param name="job">Called with each index, in no particular order</param>
+void SystemScheduler::ParallelFor(size_t jobCount, const std::function<void(size_t)>& job)
+{
+	if (jobCount == 0) return;
+
+	unsigned int hardwareThreads = std::max<unsigned int>(1u, std::thread::hardware_concurrency());
+	StartWorkers(hardwareThreads - 1);
+
+	if (jobCount == 1 || workers.empty()) {
+		for (size_t i = 0; i < jobCount; i++) {
+			job(i);
+		}
+		return;
+	}
+
+	Dispatch(jobCount, job);
+}
+
+/// <summary>
+/// Component types whose ticks for a phase are run by the scheduler rather than broadcast
+/// </summary>
+ComponentMask SystemScheduler::GetScheduledTypes(EntityEventType phase)
+{
+	return scheduledTypes[phase];
+}
+
+bool SystemScheduler::GetDeterministic()
+{
+	return deterministic;
+}
+
+/// <summary>
+/// Sets whether systems run one at a time, in registration order, on the calling thread.
+/// Useful when debugging a system that may have under-declared its access.
+/// </summary>
+void SystemScheduler::SetDeterministic(bool deterministic)
+{
+	this->deterministic = deterministic;
+}
+
+size_t SystemScheduler::GetWorkerCount()
+{
+	return workers.size();
+}
+
+/// <summary>
+/// Greedily groups each phase's systems into waves.
+/// A system goes in the first wave after the last one holding a system it
+/// conflicts with, so conflicting systems keep their registration order.
+/// </summary>
+void SystemScheduler::BuildWaves()
+{
+	size_t widestWave = 0;
+	for (EntityEventType phase : { EntityEventType::Update, EntityEventType::EditingUpdate }) {
+		std::vector<std::vector<size_t>>& phaseWaves = waves[phase];
+		phaseWaves.clear();
+
+		for (size_t i = 0; i < systems.size(); i++) {
+			ScheduledSystem& system = systems[i];
+			if (system.phase != phase) continue;
+
+			size_t target = 0;
+			for (size_t w = 0; w < phaseWaves.size(); w++) {
+				for (size_t other : phaseWaves[w]) {
+					ScheduledSystem& placed = systems[other];
+					if ((system.writes & (placed.reads | placed.writes)) || (placed.writes & system.reads)) {
+						target = w + 1;
+						break;
+					}
+				}
+			}
+
+			if (target == phaseWaves.size()) phaseWaves.emplace_back();
+			phaseWaves[target].push_back(i);
+			widestWave = std::max<size_t>(widestWave, phaseWaves[target].size());
+		}
+	}
+
+	// The calling thread takes jobs too, so it counts as one of the workers
+	unsigned int hardwareThreads = std::max<unsigned int>(1u, std::thread::hardware_concurrency());
+	StartWorkers(std::min<size_t>(widestWave, hardwareThreads) - (widestWave > 0 ? 1 : 0));
+	wavesDirty = false;
+}
+
+void SystemScheduler::StartWorkers(size_t count)
+{
+	while (workers.size() < count) {
+		workers.emplace_back(&SystemScheduler::WorkerLoop, this);
+	}
+}
+
+void SystemScheduler::RunWave(const std::vector<size_t>& wave)
+{
+	if (wave.size() == 1 || workers.empty()) {
+		for (size_t system : wave) {
+			systems[system].run();
+		}
+		return;
+	}
+
+	Dispatch(wave.size(), [this, &wave](size_t i) { systems[wave[i]].run(); });
+}
+
+/// <summary>
+/// Hands out jobCount jobs to the workers, takes some on this thread too,
+/// and waits until all have finished.
+/// If any job threw, the first exception is rethrown here once the rest are done.
+/// </summary>
+void SystemScheduler::Dispatch(size_t jobCount, const std::function<void(size_t)>& job)
+{
+	unsigned int generation;
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		currentJob = &job;
+		this->jobCount = jobCount;
+		nextJob = 0;
+		remainingJobs = jobCount;
+		generation = ++waveGeneration;
+	}
+	jobReady.notify_all();
+
+	RunJobs(generation);
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(jobMutex);
+		waveDone.wait(lock, [this]() { return remainingJobs == 0; });
+		currentJob = nullptr;
+		exception = jobException;
+		jobException = nullptr;
+	}
+
+	if (exception) std::rethrow_exception(exception);
+}
+
+/// <summary>
+/// Claims and runs jobs from the current dispatch until none are left.
+/// Jobs are claimed under the lock along with the generation check, so a
+/// worker that wakes late can never take a job from a newer dispatch by mistake.
+/// A job that throws still counts as finished, and its exception is kept for Dispatch.
+/// </summary>
+void SystemScheduler::RunJobs(unsigned int generation)
+{
+	std::unique_lock<std::mutex> lock(jobMutex);
+	while (generation == waveGeneration && currentJob != nullptr && nextJob < jobCount) {
+		size_t index = nextJob++;
+		lock.unlock();
+
+		std::exception_ptr exception;
+		try {
+			(*currentJob)(index);
+		}
+		catch (...) {
+			exception = std::current_exception();
+		}
+
+		lock.lock();
+		if (exception && !jobException) jobException = exception;
+		if (--remainingJobs == 0) waveDone.notify_all();
+	}
+}
+
+void SystemScheduler::WorkerLoop()
+{
+	unsigned int lastGeneration = 0;
+	while (true) {
+		unsigned int generation;
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobReady.wait(lock, [&]() { return shuttingDown || waveGeneration != lastGeneration; });
+			if (shuttingDown) return;
+			generation = lastGeneration = waveGeneration;
+		}
+		RunJobs(generation);
+	}
+}
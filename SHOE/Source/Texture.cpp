@@ -1,4 +1,5 @@
 #include "../Headers/Texture.h"
+#include "../Headers/AssetNameIndex.h"
 
 #pragma region Texture
 
@@ -34,7 +35,9 @@ std::string Texture::GetName() {
 }
 
 void Texture::SetName(std::string name){
+	if (this->name == name) return;
 	this->name = name;
+	AssetRenames<Texture>::Notify();
 }
 
 std::string Texture::GetTextureFilenameKey(){
@@ -69,7 +72,7 @@ DX11Texture::DX11Texture(Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> coreTe
 						 std::string fileKey,
 						 std::string name,
 						 AssetPathIndex assetPathIndex)
-	: Texture(fileKey, name, assetPathIndex)
+	: Texture(fileKey, name, assetPathIndex), videoMemory(MEMORY_TEXTURES)
 {
 	this->coreDx11Texture = coreTexture;
 	this->fileKey = fileKey;
@@ -91,6 +94,27 @@ D3D11_TEXTURE2D_DESC DX11Texture::GetTextureDesc() {
 
 void DX11Texture::SetTextureDesc(D3D11_TEXTURE2D_DESC newDesc) {
 	this->textureDesc = newDesc;
+
+	// Only an estimate for the memory stats. WIC loads nearly everything
+	// as 8 bit RGBA, so other formats are only special-cased where common.
+	size_t texelBytes = 4;
+	switch (newDesc.Format) {
+	case DXGI_FORMAT_R8_UNORM:
+		texelBytes = 1;
+		break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+		texelBytes = 8;
+		break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		texelBytes = 16;
+		break;
+	}
+
+	size_t bytes = (size_t)newDesc.Width * newDesc.Height * newDesc.ArraySize * texelBytes;
+	// A full mip chain adds about a third
+	if (newDesc.MipLevels != 1) bytes += bytes / 3;
+	videoMemory.SetSize(bytes);
 }
 
 Microsoft::WRL::ComPtr<ID3D11Texture2D> DX11Texture::GetInternalTexture() {
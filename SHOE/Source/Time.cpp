@@ -2,4 +2,5 @@
 
 float Time::deltaTime = 0.0f;
 float Time::totalTime = 0.0f;
-__int64 Time::currentTime = 0.0f;
\ No newline at end of file
+__int64 Time::currentTime = 0.0f;
+unsigned int Time::frameCount = 0;
\ No newline at end of file
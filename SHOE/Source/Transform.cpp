@@ -1,89 +1,114 @@
 #include "../Headers/Transform.h"
 #include "..\Headers\GameEntity.h"
 #include "../Headers/Light.h"
+#include "../Headers/Time.h"
 
 using namespace DirectX;
 
 void Transform::Start() {
 	this->parent = nullptr;
-	this->matricesDirty = false;
-	this->vectorsDirty = false;
-	this->globalsDirty = true;
-
-	this->position = XMFLOAT3(0, 0, 0);
 	this->pitchYawRoll = XMFLOAT3(0, 0, 0);
-	this->scale = XMFLOAT3(1, 1, 1);
+	this->pitchYawRollDirty = false;
+	this->lastChangedFrame = Time::frameCount;
+	this->transformChangedThisFrame = false;
 
-	this->up = XMFLOAT3(0, 1, 0);
-	this->right = XMFLOAT3(1, 0, 0);
-	this->forward = XMFLOAT3(0, 0, 1);
+	// Starts as an identity root with an up to date world matrix
+	if (hierarchyIndex == TRANSFORM_NO_INDEX) hierarchyIndex = TransformHierarchy::Allocate(this);
 
-	XMStoreFloat4x4(&worldMatrix, XMMatrixIdentity());
-	XMStoreFloat4x4(&worldInverseTransposeMatrix, XMMatrixIdentity());
 	this->children.clear();
 	this->childEntities.clear();
 }
 
-void Transform::Update()
-{
-	if (transformChangedThisFrame) {
-		transformChangedThisFrame = false;
-		GetGameEntity()->PropagateEvent(EntityEventType::OnTransform);
-		GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentTransform, GetGameEntity());
-	}
-}
-
-void Transform::EditingUpdate()
-{
-	if (transformChangedThisFrame) {
-		transformChangedThisFrame = false;
-		GetGameEntity()->PropagateEvent(EntityEventType::OnTransform);
-		GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentTransform, GetGameEntity());
-	}
-}
+std::vector<ComponentHandle> Transform::changedTransforms = std::vector<ComponentHandle>();
+unsigned int Transform::notifyPass = 0;
 
 void Transform::OnDestroy()
 {
 	parent = nullptr;
-}
 
-void Transform::OnMove(DirectX::XMFLOAT3 delta)
-{
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentMove, GetGameEntity());
+	if (hierarchyIndex != TRANSFORM_NO_INDEX) {
+		TransformHierarchy::Release(hierarchyIndex);
+		hierarchyIndex = TRANSFORM_NO_INDEX;
+	}
 }
 
-void Transform::OnRotate(DirectX::XMFLOAT3 delta)
+XMFLOAT3& Transform::LocalPosition()
 {
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentRotate, GetGameEntity());
+	return TransformHierarchy::localPositions[hierarchyIndex];
 }
 
-void Transform::OnScale(DirectX::XMFLOAT3 delta)
+XMFLOAT4& Transform::LocalRotation()
 {
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentScale, GetGameEntity());
+	return TransformHierarchy::localRotations[hierarchyIndex];
 }
 
-void Transform::OnParentTransform(std::shared_ptr<GameEntity> parent)
+XMFLOAT3& Transform::LocalScale()
 {
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentTransform, parent);
+	return TransformHierarchy::localScales[hierarchyIndex];
 }
 
-void Transform::OnParentMove(std::shared_ptr<GameEntity> parent)
+/// <summary>
+/// Sends the change notifications for every transform changed since the last call.
+/// Each changed subtree is walked once, parents before children, and every
+/// entity in it gets a single OnTransform if it changed itself, or else a single
+/// OnParentTransform naming its nearest changed ancestor, however many times
+/// anything in the subtree was moved. Call once per frame, after everything
+/// that moves transforms has run.
+/// </summary>
+void Transform::NotifyChanges()
 {
-	MarkMatricesDirty();
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentMove, parent);
+	if (changedTransforms.empty()) return;
+
+	// Transforms changed by the handlers below are notified next frame
+	std::vector<ComponentHandle> changed;
+	changed.swap(changedTransforms);
+	notifyPass++;
+
+	for (ComponentHandle handle : changed) {
+		Transform* transform = ComponentManager::Get<Transform>(handle);
+		if (transform == nullptr || !transform->transformChangedThisFrame) continue;
+
+		// Start from the highest changed ancestor, so its walk covers this one too
+		Transform* root = transform;
+		for (Transform* ancestor = transform->parent.get(); ancestor != nullptr; ancestor = ancestor->parent.get()) {
+			if (ancestor->transformChangedThisFrame) root = ancestor;
+		}
+
+		if (root->notifiedPass != notifyPass) root->NotifySubtree(nullptr);
+	}
 }
 
-void Transform::OnParentRotate(std::shared_ptr<GameEntity> parent)
+void Transform::NotifySubtree(std::shared_ptr<GameEntity> changedAncestor)
 {
-	MarkMatricesDirty();
-	MarkVectorsDirty();
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentRotate, parent);
+	if (notifiedPass == notifyPass) return;
+	notifiedPass = notifyPass;
+
+	std::shared_ptr<GameEntity> entity = GetGameEntity();
+	if (entity == nullptr) return;
+
+	if (transformChangedThisFrame) {
+		transformChangedThisFrame = false;
+		entity->PropagateEvent<EntityEventType::OnTransform>();
+		changedAncestor = entity;
+	}
+	else {
+		entity->PropagateEvent<EntityEventType::OnParentTransform>(changedAncestor);
+	}
+
+	for (size_t i = 0; i < children.size(); i++) {
+		children[i]->NotifySubtree(changedAncestor);
+	}
 }
 
-void Transform::OnParentScale(std::shared_ptr<GameEntity> parent)
+/// <summary>
+/// Queues this transform for the next NotifyChanges, once per change
+/// </summary>
+void Transform::QueueChangeNotification()
 {
-	MarkMatricesDirty();
-	GetGameEntity()->PropagateEventToChildren(EntityEventType::OnParentScale, parent);
+	if (transformChangedThisFrame || GetGameEntity() == nullptr) return;
+
+	transformChangedThisFrame = true;
+	changedTransforms.push_back(GetHandle());
 }
 
 #pragma region Setters
@@ -92,12 +117,13 @@ void Transform::SetPosition(float x, float y, float z) {
 }
 
 void Transform::SetPosition(XMFLOAT3 pos) {
+	XMFLOAT3& position = LocalPosition();
 	if (position.x != pos.x || position.y != pos.y || position.z != pos.z) {
-		std::shared_ptr<XMFLOAT3> delta = std::make_shared<XMFLOAT3>(pos.x - position.x, pos.y - position.y, pos.z - position.z);
+		XMFLOAT3 delta = XMFLOAT3(pos.x - position.x, pos.y - position.y, pos.z - position.z);
 		position = pos;
 		MarkMatricesDirty();
-		transformChangedThisFrame = true;
-		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent(EntityEventType::OnMove, delta);
+		QueueChangeNotification();
+		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent<EntityEventType::OnMove>(delta);
 	}
 }
 
@@ -106,13 +132,39 @@ void Transform::SetRotation(float pitch, float yaw, float roll) {
 }
 
 void Transform::SetRotation(XMFLOAT3 rot) {
-	if (pitchYawRoll.x != rot.x || pitchYawRoll.y != rot.y || pitchYawRoll.z != rot.z) {
-		std::shared_ptr<XMFLOAT3> delta = std::make_shared<XMFLOAT3>(rot.x - pitchYawRoll.x, rot.y - pitchYawRoll.y, rot.z - pitchYawRoll.z);
-		pitchYawRoll = XMFLOAT3(rot.x, rot.y, rot.z);
+	XMFLOAT3 current = GetLocalPitchYawRoll();
+	if (current.x != rot.x || current.y != rot.y || current.z != rot.z) {
+		XMFLOAT3 delta = XMFLOAT3(rot.x - current.x, rot.y - current.y, rot.z - current.z);
+		pitchYawRoll = rot;
+		XMStoreFloat4(&LocalRotation(), XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&rot)));
 		MarkMatricesDirty();
-		MarkVectorsDirty();
-		transformChangedThisFrame = true;
-		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent(EntityEventType::OnRotate, delta);
+		QueueChangeNotification();
+		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent<EntityEventType::OnRotate>(delta);
+	}
+}
+
+/// <summary>
+/// Sets the local rotation directly, without going through euler angles.
+/// OnRotate still gets the change as pitch, yaw and roll.
+/// </summary>
+void Transform::SetRotation(XMFLOAT4 quaternion) {
+	XMFLOAT4& rotation = LocalRotation();
+	if (rotation.x != quaternion.x || rotation.y != quaternion.y || rotation.z != quaternion.z || rotation.w != quaternion.w) {
+		// Only worth converting to euler angles if there's an entity to send them to
+		if (GetGameEntity() == nullptr) {
+			rotation = quaternion;
+			pitchYawRollDirty = true;
+			MarkMatricesDirty();
+			return;
+		}
+
+		XMFLOAT3 previous = GetLocalPitchYawRoll();
+		rotation = quaternion;
+		pitchYawRoll = QuaternionToEuler(quaternion);
+		pitchYawRollDirty = false;
+		MarkMatricesDirty();
+		QueueChangeNotification();
+		GetGameEntity()->PropagateEvent<EntityEventType::OnRotate>(XMFLOAT3(pitchYawRoll.x - previous.x, pitchYawRoll.y - previous.y, pitchYawRoll.z - previous.z));
 	}
 }
 
@@ -121,98 +173,263 @@ void Transform::SetScale(float x, float y, float z) {
 }
 
 void Transform::SetScale(XMFLOAT3 scale) {
-	if (this->scale.x != scale.x || this->scale.y != scale.y || this->scale.z != scale.z) {
-		std::shared_ptr<XMFLOAT3> delta = std::make_shared<XMFLOAT3>(scale.x - this->scale.x, scale.y - this->scale.y, scale.z - this->scale.z);
-		this->scale = scale;
+	XMFLOAT3& localScale = LocalScale();
+	if (localScale.x != scale.x || localScale.y != scale.y || localScale.z != scale.z) {
+		XMFLOAT3 delta = XMFLOAT3(scale.x - localScale.x, scale.y - localScale.y, scale.z - localScale.z);
+		localScale = scale;
 		MarkMatricesDirty();
-		transformChangedThisFrame = true;
-		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent(EntityEventType::OnScale, delta);
+		QueueChangeNotification();
+		if (GetGameEntity() != nullptr) GetGameEntity()->PropagateEvent<EntityEventType::OnScale>(delta);
 	}
 }
 # pragma endregion
 
+#pragma region Batched Setters
+/// <summary>
+/// Sets the local positions of many transforms at once, writing straight into the
+/// TransformHierarchy. No OnMove is sent. Each transform that changed gets one
+/// OnTransform from the next NotifyChanges instead, as with any other change.
+/// Stale handles, and positions that match the current ones, are skipped.
+/// </summary>
+/// <param name="transforms">Transforms to move</param>
+/// <param name="positions">New local position of each transform, in the same order</param>
+void Transform::SetLocalPositions(std::span<const ComponentHandle> transforms, std::span<const XMFLOAT3> positions)
+{
+	size_t count = std::min<size_t>(transforms.size(), positions.size());
+	for (size_t i = 0; i < count; i++) {
+		Transform* transform = ComponentManager::Get<Transform>(transforms[i]);
+		if (transform == nullptr) continue;
+
+		XMFLOAT3& position = transform->LocalPosition();
+		const XMFLOAT3& newPosition = positions[i];
+		if (position.x == newPosition.x && position.y == newPosition.y && position.z == newPosition.z) continue;
+
+		position = newPosition;
+		transform->MarkBatchedChange();
+	}
+}
+
+/// <summary>
+/// Sets the local rotations of many transforms at once. Works like SetLocalPositions,
+/// and no OnRotate is sent. The euler views are only worked out if asked for.
+/// </summary>
+/// <param name="transforms">Transforms to rotate</param>
+/// <param name="rotations">New local rotation quaternion of each transform, in the same order</param>
+void Transform::SetLocalRotations(std::span<const ComponentHandle> transforms, std::span<const XMFLOAT4> rotations)
+{
+	size_t count = std::min<size_t>(transforms.size(), rotations.size());
+	for (size_t i = 0; i < count; i++) {
+		Transform* transform = ComponentManager::Get<Transform>(transforms[i]);
+		if (transform == nullptr) continue;
+
+		XMFLOAT4& rotation = transform->LocalRotation();
+		const XMFLOAT4& newRotation = rotations[i];
+		if (rotation.x == newRotation.x && rotation.y == newRotation.y && rotation.z == newRotation.z && rotation.w == newRotation.w) continue;
+
+		rotation = newRotation;
+		transform->pitchYawRollDirty = true;
+		transform->MarkBatchedChange();
+	}
+}
+
+/// <summary>
+/// Sets the local scales of many transforms at once. Works like SetLocalPositions,
+/// and no OnScale is sent.
+/// </summary>
+/// <param name="transforms">Transforms to scale</param>
+/// <param name="scales">New local scale of each transform, in the same order</param>
+void Transform::SetLocalScales(std::span<const ComponentHandle> transforms, std::span<const XMFLOAT3> scales)
+{
+	size_t count = std::min<size_t>(transforms.size(), scales.size());
+	for (size_t i = 0; i < count; i++) {
+		Transform* transform = ComponentManager::Get<Transform>(transforms[i]);
+		if (transform == nullptr) continue;
+
+		XMFLOAT3& scale = transform->LocalScale();
+		const XMFLOAT3& newScale = scales[i];
+		if (scale.x == newScale.x && scale.y == newScale.y && scale.z == newScale.z) continue;
+
+		scale = newScale;
+		transform->MarkBatchedChange();
+	}
+}
+
+/// <summary>
+/// Sets the whole local transform of many transforms at once, such as a pose
+/// sampled from an animation. Works like SetLocalPositions, and sends none of
+/// OnMove, OnRotate or OnScale.
+/// </summary>
+/// <param name="transforms">Transforms to set</param>
+/// <param name="values">New local position, rotation and scale of each transform, in the same order</param>
+void Transform::SetLocalTRS(std::span<const ComponentHandle> transforms, std::span<const TransformTRS> values)
+{
+	size_t count = std::min<size_t>(transforms.size(), values.size());
+	for (size_t i = 0; i < count; i++) {
+		Transform* transform = ComponentManager::Get<Transform>(transforms[i]);
+		if (transform == nullptr) continue;
+
+		XMFLOAT3& position = transform->LocalPosition();
+		XMFLOAT4& rotation = transform->LocalRotation();
+		XMFLOAT3& scale = transform->LocalScale();
+		const TransformTRS& value = values[i];
+
+		bool rotated = rotation.x != value.rotation.x || rotation.y != value.rotation.y || rotation.z != value.rotation.z || rotation.w != value.rotation.w;
+		bool moved = position.x != value.position.x || position.y != value.position.y || position.z != value.position.z;
+		bool scaled = scale.x != value.scale.x || scale.y != value.scale.y || scale.z != value.scale.z;
+		if (!rotated && !moved && !scaled) continue;
+
+		position = value.position;
+		rotation = value.rotation;
+		scale = value.scale;
+		if (rotated) transform->pitchYawRollDirty = true;
+		transform->MarkBatchedChange();
+	}
+}
+
+/// <summary>
+/// Invalidates the world matrix and queues the coalesced OnTransform,
+/// standing in for everything a single setter does after writing
+/// </summary>
+void Transform::MarkBatchedChange()
+{
+	MarkMatricesDirty();
+	QueueChangeNotification();
+}
+#pragma endregion
+
 #pragma region Getters
 XMFLOAT3 Transform::GetLocalPosition() {
-	return position;
+	return LocalPosition();
 }
 
+/// <summary>
+/// The world matrix's translation, so no decomposition is needed
+/// </summary>
 DirectX::XMFLOAT3 Transform::GetGlobalPosition()
 {
-	UpdateGlobals();
-	return worldPos;
+	TransformHierarchy::UpdateWorldMatrix(hierarchyIndex);
+	XMFLOAT4X4A& world = TransformHierarchy::worldMatrices[hierarchyIndex];
+	return XMFLOAT3(world._41, world._42, world._43);
 }
 
 XMFLOAT3 Transform::GetLocalPitchYawRoll() {
+	if (pitchYawRollDirty) {
+		pitchYawRoll = QuaternionToEuler(LocalRotation());
+		pitchYawRollDirty = false;
+	}
 	return pitchYawRoll;
 }
 
+XMFLOAT4 Transform::GetLocalRotation() {
+	return LocalRotation();
+}
+
+/// <summary>
+/// Composed from the local rotations by the TransformHierarchy, so no decomposition is needed
+/// </summary>
 DirectX::XMFLOAT4 Transform::GetGlobalRotation()
 {
-	UpdateGlobals();
-	return worldRotQuat;
+	TransformHierarchy::UpdateWorldMatrix(hierarchyIndex);
+	return TransformHierarchy::worldRotations[hierarchyIndex];
 }
 
 XMFLOAT3 Transform::GetLocalScale() {
-	return this->scale;
+	return LocalScale();
 }
 
+/// <summary>
+/// Composed from the local scales by the TransformHierarchy, so no decomposition is needed
+/// </summary>
 DirectX::XMFLOAT3 Transform::GetGlobalScale()
 {
-	UpdateGlobals();
-	return worldScale;
+	TransformHierarchy::UpdateWorldMatrix(hierarchyIndex);
+	return TransformHierarchy::worldScales[hierarchyIndex];
 }
 
 XMFLOAT3 Transform::GetUp()
 {
-	UpdateVectors();
+	XMFLOAT3 up;
+	XMStoreFloat3(&up, XMVector3Rotate(XMVectorSet(0, 1, 0, 0), XMLoadFloat4(&GetGlobalRotation())));
 	return up;
 }
 
 XMFLOAT3 Transform::GetRight()
 {
-	UpdateVectors();
+	XMFLOAT3 right;
+	XMStoreFloat3(&right, XMVector3Rotate(XMVectorSet(1, 0, 0, 0), XMLoadFloat4(&GetGlobalRotation())));
 	return right;
 }
 
 XMFLOAT3 Transform::GetForward()
 {
-	UpdateVectors();
+	XMFLOAT3 forward;
+	XMStoreFloat3(&forward, XMVector3Rotate(XMVectorSet(0, 0, 1, 0), XMLoadFloat4(&GetGlobalRotation())));
 	return forward;
 }
 
 
 XMFLOAT4X4 Transform::GetWorldMatrix()
 {
-	UpdateMatrices();
-	return this->worldMatrix;
+	TransformHierarchy::UpdateWorldMatrix(hierarchyIndex);
+	return TransformHierarchy::worldMatrices[hierarchyIndex];
 }
 
+/// <summary>
+/// For transforming normals. Worked out the first time it's asked for after each
+/// change, or ahead of time for many transforms by TransformHierarchy::UpdateInverseTransposes.
+/// </summary>
 XMFLOAT4X4 Transform::GetWorldInverseTransposeMatrix()
 {
-	UpdateMatrices();
-	return worldMatrix;
+	TransformHierarchy::UpdateInverseTranspose(hierarchyIndex);
+	return TransformHierarchy::worldInverseTransposes[hierarchyIndex];
 }
 
-void Transform::MarkMatricesDirty()
+/// <summary>
+/// Version of the world matrix, which goes up each time it changes, whether
+/// through this transform or an ancestor. Save it alongside anything worked out
+/// from the world matrix, and compare later to tell if that needs redoing.
+/// </summary>
+uint32_t Transform::GetWorldVersion()
 {
-	matricesDirty = true;
-	MarkGlobalsDirty();
+	TransformHierarchy::UpdateWorldMatrix(hierarchyIndex);
+	return TransformHierarchy::worldVersions[hierarchyIndex];
 }
 
-void Transform::MarkVectorsDirty()
+/// <summary>
+/// Whether the world matrix has changed since GetWorldVersion returned version
+/// </summary>
+bool Transform::WorldChangedSince(uint32_t version)
 {
-	vectorsDirty = true;
+	return GetWorldVersion() != version;
 }
 
-void Transform::MarkGlobalsDirty()
+/// <summary>
+/// Whether this transform's world matrix was invalidated this frame,
+/// by itself or by an ancestor
+/// </summary>
+bool Transform::ChangedThisFrame()
 {
-	globalsDirty = true;
+	for (Transform* transform = this; transform != nullptr; transform = transform->parent.get()) {
+		if (transform->lastChangedFrame == Time::frameCount) return true;
+	}
+	return false;
+}
+
+/// <summary>
+/// Invalidates this transform's world matrix. Descendants notice through
+/// the TransformHierarchy's versions, so they aren't visited.
+/// </summary>
+void Transform::MarkMatricesDirty()
+{
+	TransformHierarchy::MarkChanged(hierarchyIndex);
+	lastChangedFrame = Time::frameCount;
 }
 
 #pragma endregion
 
 #pragma region Transformation Methods
 void Transform::MoveAbsolute(float x, float y, float z) {
+	XMFLOAT3 position = LocalPosition();
 	SetPosition(XMFLOAT3(x + position.x, y + position.y, z + position.z));
 }
 
@@ -222,6 +439,7 @@ void Transform::MoveAbsolute(DirectX::XMFLOAT3 offset)
 }
 
 void Transform::Rotate(float pitch, float yaw, float roll) {
+	XMFLOAT3 pitchYawRoll = GetLocalPitchYawRoll();
 	SetRotation(XMFLOAT3(pitch + pitchYawRoll.x, yaw + pitchYawRoll.y, roll + pitchYawRoll.z));
 }
 
@@ -231,6 +449,7 @@ void Transform::Rotate(DirectX::XMFLOAT3 pitchYawRoll)
 }
 
 void Transform::Scale(float x, float y, float z) {
+	XMFLOAT3 scale = LocalScale();
 	SetScale(XMFLOAT3(x * scale.x, y * scale.y, z * scale.z));
 }
 
@@ -243,12 +462,10 @@ void Transform::MoveRelative(float x, float y, float z)
 {
 	if (x == 0 && y == 0 && z == 0) return;
 	XMVECTOR desiredMovement = XMVectorSet(x, y, z, 0);
-	XMVECTOR rotQuat = XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll));
-
-	XMVECTOR dir = XMVector3Rotate(desiredMovement, rotQuat);
+	XMVECTOR dir = XMVector3Rotate(desiredMovement, XMLoadFloat4(&LocalRotation()));
 
 	XMFLOAT3 finalPos;
-	XMStoreFloat3(&finalPos, XMLoadFloat3(&position) + dir);
+	XMStoreFloat3(&finalPos, XMLoadFloat3(&LocalPosition()) + dir);
 
 	SetPosition(finalPos);
 }
@@ -259,88 +476,28 @@ void Transform::MoveRelative(DirectX::XMFLOAT3 offset)
 }
 #pragma endregion
 
-void Transform::UpdateMatrices()
-{
-	if (!matricesDirty) return;
-
-	// Create the three transformation pieces
-	XMMATRIX trans = XMMatrixTranslationFromVector(XMLoadFloat3(&position));
-	XMMATRIX rot = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll));
-	XMMATRIX sc = XMMatrixScalingFromVector(XMLoadFloat3(&scale));
-
-	// Combine and store the world
-	XMMATRIX wm = sc * rot * trans;
-
-	if (parent != nullptr)
-	{
-		XMFLOAT4X4 parentWorld = parent->GetWorldMatrix();
-		wm *= XMLoadFloat4x4(&parentWorld);
-	}
-
-	// Store both versions
-	XMStoreFloat4x4(&worldMatrix, wm);
-	XMStoreFloat4x4(&worldInverseTransposeMatrix, XMMatrixInverse(0, XMMatrixTranspose(wm)));
-
-	// Matrices are up to date
-	matricesDirty = false;
-}
-
-void Transform::UpdateVectors()
-{
-	if (!vectorsDirty) return;
-
-	// Update all three vectors
-	XMVECTOR rotationQuat = XMLoadFloat4(&GetGlobalRotation());
-	XMStoreFloat3(&up, XMVector3Rotate(XMVectorSet(0, 1, 0, 0), rotationQuat));
-	XMStoreFloat3(&right, XMVector3Rotate(XMVectorSet(1, 0, 0, 0), rotationQuat));
-	XMStoreFloat3(&forward, XMVector3Rotate(XMVectorSet(0, 0, 1, 0), rotationQuat));
-
-	// Vectors are up to date
-	vectorsDirty = false;
-}
-
-void Transform::UpdateGlobals()
-{
-	if (!globalsDirty) return;
-
-	XMFLOAT4X4 wM = GetWorldMatrix();
-
-	// Decompose the matrix
-	XMVECTOR globalPos;
-	XMVECTOR globalRotQuat;
-	XMVECTOR globalScale;
-	XMMatrixDecompose(&globalScale, &globalRotQuat, &globalPos, XMLoadFloat4x4(&wM));
-
-	XMStoreFloat3(&worldPos, globalPos);
-	XMStoreFloat4(&worldRotQuat, globalRotQuat);
-	XMStoreFloat3(&worldScale, globalScale);
-
-	globalsDirty = false;
-}
-
 void Transform::AddChild(std::shared_ptr<Transform> child) {
 	if (child == nullptr) return;
 	if (std::find(children.begin(), children.end(), child) == children.end()) {
-		XMFLOAT4X4 parentWorld = GetWorldMatrix();
-		XMMATRIX pWorld = XMLoadFloat4x4(&parentWorld);
-
-		XMFLOAT4X4 childWorld = child->GetWorldMatrix();
-		XMMATRIX cWorld = XMLoadFloat4x4(&childWorld);
-
-		// Invert the parent
-		XMMATRIX pWorldInv = XMMatrixInverse(0, pWorld);
-
-		// Multiply the child by the inverse parent
-		XMMATRIX relCWorld = cWorld * pWorldInv;
-
-		// Set the child's transform from this new matrix
-		XMFLOAT4X4 relativeChildWorld;
-		XMStoreFloat4x4(&relativeChildWorld, relCWorld);
-		child->SetTransformsFromMatrix(relativeChildWorld);
+		// Keep the child where it is by making its world transform relative to this one.
+		// Undoing the parent's translation, rotation and scale in turn avoids
+		// inverting and decomposing a matrix.
+		XMVECTOR parentRotation = XMLoadFloat4(&GetGlobalRotation());
+		XMVECTOR parentScale = XMLoadFloat3(&GetGlobalScale());
+		XMVECTOR offset = XMLoadFloat3(&child->GetGlobalPosition()) - XMLoadFloat3(&GetGlobalPosition());
+
+		XMFLOAT3 relativePosition;
+		XMFLOAT4 relativeRotation;
+		XMFLOAT3 relativeScale;
+		XMStoreFloat3(&relativePosition, XMVector3InverseRotate(offset, parentRotation) / parentScale);
+		XMStoreFloat4(&relativeRotation, XMQuaternionMultiply(XMLoadFloat4(&child->GetGlobalRotation()), XMQuaternionInverse(parentRotation)));
+		XMStoreFloat3(&relativeScale, XMLoadFloat3(&child->GetGlobalScale()) / parentScale);
+		child->SetLocalTransform(relativePosition, relativeRotation, relativeScale);
 
 		children.push_back(child);
 		childEntities.push_back(child->GetGameEntity());
 		child->parent = shared_from_this();
+		TransformHierarchy::SetParent(child->hierarchyIndex, hierarchyIndex);
 
 		child->GetGameEntity()->UpdateHierarchyIsEnabled(GetGameEntity()->GetEnabled());
 	}
@@ -350,12 +507,13 @@ void Transform::RemoveChild(std::shared_ptr<Transform> child) {
 	if (child == nullptr) return;
 	for (int i = 0; i < children.size(); i++) {
 		if (children[i] == child) {
-			// Set the child's transform data using its final matrix
-			child->SetTransformsFromMatrix(child->GetWorldMatrix());
+			// Keep the child where it is by making its world transform its local one
+			child->SetLocalTransform(child->GetGlobalPosition(), child->GetGlobalRotation(), child->GetGlobalScale());
 
 			children.erase(children.begin() + i);
 			childEntities.erase(childEntities.begin() + i);
 			child->parent = nullptr;
+			TransformHierarchy::SetParent(child->hierarchyIndex, TRANSFORM_NO_INDEX);
 
 			child->GetGameEntity()->UpdateHierarchyIsEnabled(true);
 			return;
@@ -382,7 +540,8 @@ void Transform::SetParent(std::shared_ptr<Transform> newParent) {
 void Transform::SetParentNoReciprocate(std::shared_ptr<Transform> parent)
 {
 	this->parent = parent;
-	globalsDirty = true;
+	TransformHierarchy::SetParent(hierarchyIndex, parent != nullptr ? parent->hierarchyIndex : TRANSFORM_NO_INDEX);
+	MarkMatricesDirty();
 }
 
 std::shared_ptr<Transform> Transform::GetParent() {
@@ -404,26 +563,19 @@ std::vector<std::shared_ptr<GameEntity>> Transform::GetChildrenEntities() {
 	return childEntities;
 }
 
-void Transform::SetTransformsFromMatrix(DirectX::XMFLOAT4X4 worldMatrix)
+/// <summary>
+/// Overwrites the local transform without sending any events, for reparenting.
+/// The euler view is only worked out again if something asks for it.
+/// </summary>
+void Transform::SetLocalTransform(DirectX::XMFLOAT3 position, DirectX::XMFLOAT4 rotation, DirectX::XMFLOAT3 scale)
 {
-	// Decompose the matrix
-	XMVECTOR localPos;
-	XMVECTOR localRotQuat;
-	XMVECTOR localScale;
-	XMMatrixDecompose(&localScale, &localRotQuat, &localPos, XMLoadFloat4x4(&worldMatrix));
-
-	// Get the euler angles from the quaternion and store as our 
-	XMFLOAT4 quat;
-	XMStoreFloat4(&quat, localRotQuat);
-	pitchYawRoll = QuaternionToEuler(quat);
-
-	// Overwrite the child's other transform data
-	XMStoreFloat3(&position, localPos);
-	XMStoreFloat3(&scale, localScale);
+	LocalPosition() = position;
+	LocalRotation() = rotation;
+	LocalScale() = scale;
+	pitchYawRollDirty = true;
 
 	// Things have changed
-	matricesDirty = true;
-	vectorsDirty = true;
+	TransformHierarchy::MarkChanged(hierarchyIndex);
 }
 
 DirectX::XMFLOAT3 Transform::QuaternionToEuler(DirectX::XMFLOAT4 quaternion)
@@ -0,0 +1,465 @@
+#include "..\Headers\TransformHierarchy.h"
+
+#include <algorithm>
+#include "..\Headers\Transform.h"
+#include "..\Headers\MemoryTracker.h"
+#include "..\Headers\SystemScheduler.h"
+
+using namespace DirectX;
+
+std::vector<XMFLOAT3> TransformHierarchy::localPositions = std::vector<XMFLOAT3>();
+std::vector<XMFLOAT4> TransformHierarchy::localRotations = std::vector<XMFLOAT4>();
+std::vector<XMFLOAT3> TransformHierarchy::localScales = std::vector<XMFLOAT3>();
+std::vector<uint32_t> TransformHierarchy::parents = std::vector<uint32_t>();
+std::vector<XMFLOAT4X4A> TransformHierarchy::worldMatrices = std::vector<XMFLOAT4X4A>();
+std::vector<XMFLOAT4> TransformHierarchy::worldRotations = std::vector<XMFLOAT4>();
+std::vector<XMFLOAT3> TransformHierarchy::worldScales = std::vector<XMFLOAT3>();
+std::vector<XMFLOAT4X4A> TransformHierarchy::worldInverseTransposes = std::vector<XMFLOAT4X4A>();
+std::vector<uint32_t> TransformHierarchy::localVersions = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::worldVersions = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::builtLocalVersions = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::builtParentVersions = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::inverseTransposeVersions = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::verifiedAt = std::vector<uint32_t>();
+uint32_t TransformHierarchy::changeCount = 0;
+uint32_t TransformHierarchy::passChangeCount = 0;
+std::vector<Transform*> TransformHierarchy::owners = std::vector<Transform*>();
+std::vector<uint32_t> TransformHierarchy::freeSlots = std::vector<uint32_t>();
+bool TransformHierarchy::orderDirty = false;
+std::vector<uint32_t> TransformHierarchy::levelStarts = std::vector<uint32_t>();
+bool TransformHierarchy::levelsDirty = true;
+std::vector<uint32_t> TransformHierarchy::staleInverseTransposes = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::sortDepths = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::sortOrder = std::vector<uint32_t>();
+std::vector<uint32_t> TransformHierarchy::sortNewIndices = std::vector<uint32_t>();
+
+namespace {
+	/// <summary>
+	/// Reorders values so the value at order[i] ends up at i
+	/// </summary>
+	template <typename T>
+	void Permute(std::vector<T>& values, const std::vector<uint32_t>& order)
+	{
+		std::vector<T> sorted = std::vector<T>();
+		sorted.reserve(order.size());
+		for (uint32_t oldIndex : order) {
+			sorted.push_back(values[oldIndex]);
+		}
+		values.swap(sorted);
+	}
+}
+
+/// <summary>
+/// Brings every dirty world matrix up to date. Call once per frame from the
+/// main thread, after everything that moves transforms has run.
+/// Small scenes, or machines with one hardware thread, take the serial pass.
+/// Nothing is done if nothing has changed since the last pass.
+/// </summary>
+void TransformHierarchy::UpdateWorldMatrices()
+{
+	if (changeCount == passChangeCount && !orderDirty) return;
+
+	if (owners.size() < ParallelThreshold || std::thread::hardware_concurrency() <= 1) {
+		UpdateWorldMatricesSerial();
+	}
+	else {
+		UpdateWorldMatricesParallel();
+	}
+	passChangeCount = changeCount;
+}
+
+/// <summary>
+/// One pass over the slots on the calling thread.
+/// Re-sorts the slots first if reparenting broke the order.
+/// </summary>
+void TransformHierarchy::UpdateWorldMatricesSerial()
+{
+	if (orderDirty) SortByDepth();
+
+	UpdateRange(0, (uint32_t)owners.size());
+}
+
+/// <summary>
+/// Updates one depth at a time, each split into chunks run across the worker pool.
+/// A slot only reads its parent, which is a depth above, so the chunks of one depth
+/// never touch each other's slots. Re-sorts first if any parent changed since the
+/// last sort, to bring the depth ranges up to date.
+/// </summary>
+void TransformHierarchy::UpdateWorldMatricesParallel()
+{
+	if (orderDirty || levelsDirty) SortByDepth();
+
+	SystemScheduler& scheduler = SystemScheduler::GetInstance();
+	for (size_t level = 0; level + 1 < levelStarts.size(); level++) {
+		uint32_t begin = levelStarts[level];
+		uint32_t end = levelStarts[level + 1];
+		uint32_t chunks = (end - begin + ChunkSize - 1) / ChunkSize;
+
+		if (chunks <= 1) {
+			UpdateRange(begin, end);
+			continue;
+		}
+
+		scheduler.ParallelFor(chunks, [begin, end](size_t chunk) {
+			uint32_t chunkBegin = begin + (uint32_t)chunk * ChunkSize;
+			UpdateRange(chunkBegin, std::min<uint32_t>(chunkBegin + ChunkSize, end));
+		});
+	}
+
+	// Roots added since the sort, and any children given to them
+	UpdateRange(levelStarts.empty() ? 0 : levelStarts.back(), (uint32_t)owners.size());
+}
+
+/// <summary>
+/// Updates the out of date slots in [begin, end), in order.
+/// Every parent comes first, so each is already current and only
+/// its world version needs comparing.
+/// </summary>
+void TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end)
+{
+	for (uint32_t i = begin; i < end; i++) {
+		if (verifiedAt[i] == changeCount) continue;
+
+		uint32_t parent = parents[i];
+		if (localVersions[i] != builtLocalVersions[i] || (parent != TRANSFORM_NO_INDEX && worldVersions[parent] != builtParentVersions[i])) {
+			ComputeWorldMatrix(i);
+		}
+		verifiedAt[i] = changeCount;
+	}
+}
+
+/// <summary>
+/// How many transforms have a slot
+/// </summary>
+uint32_t TransformHierarchy::GetCount()
+{
+	return (uint32_t)(owners.size() - freeSlots.size());
+}
+
+/// <summary>
+/// How many world matrices the next UpdateWorldMatrices would recompute
+/// </summary>
+uint32_t TransformHierarchy::GetDirtyCount()
+{
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < owners.size(); i++) {
+		if (owners[i] != nullptr && IsStale(i)) count++;
+	}
+	return count;
+}
+
+/// <summary>
+/// Gives a transform a slot, as a root with an identity local transform.
+/// A root can sit anywhere in the order, so freed slots are reused as is.
+/// </summary>
+/// <param name="owner">Transform the slot belongs to</param>
+/// <returns>Index of the slot</returns>
+uint32_t TransformHierarchy::Allocate(Transform* owner)
+{
+	uint32_t index;
+	if (!freeSlots.empty()) {
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else {
+		MemoryScope scope(MEMORY_COMPONENT_POOLS);
+
+		index = (uint32_t)owners.size();
+		localPositions.emplace_back();
+		localRotations.emplace_back();
+		localScales.emplace_back();
+		parents.push_back(TRANSFORM_NO_INDEX);
+		worldMatrices.emplace_back();
+		worldRotations.emplace_back();
+		worldScales.emplace_back();
+		worldInverseTransposes.emplace_back();
+		localVersions.push_back(0);
+		worldVersions.push_back(0);
+		builtLocalVersions.push_back(0);
+		builtParentVersions.push_back(0);
+		inverseTransposeVersions.push_back(0);
+		verifiedAt.push_back(0);
+		owners.push_back(nullptr);
+	}
+
+	localPositions[index] = XMFLOAT3(0, 0, 0);
+	localRotations[index] = XMFLOAT4(0, 0, 0, 1);
+	localScales[index] = XMFLOAT3(1, 1, 1);
+	parents[index] = TRANSFORM_NO_INDEX;
+	XMStoreFloat4x4A(&worldMatrices[index], XMMatrixIdentity());
+	worldRotations[index] = XMFLOAT4(0, 0, 0, 1);
+	worldScales[index] = XMFLOAT3(1, 1, 1);
+	XMStoreFloat4x4A(&worldInverseTransposes[index], XMMatrixIdentity());
+	owners[index] = owner;
+
+	// A reused slot's versions carry on from where they were, so
+	// the new owner's world matrix counts as changed
+	worldVersions[index]++;
+	builtLocalVersions[index] = localVersions[index];
+	builtParentVersions[index] = 0;
+	inverseTransposeVersions[index] = worldVersions[index];
+	verifiedAt[index] = changeCount;
+
+	return index;
+}
+
+/// <summary>
+/// Frees a slot. Nothing may still have it as a parent.
+/// The slot is left in place, so the order stays valid, until the next sort drops it.
+/// </summary>
+void TransformHierarchy::Release(uint32_t index)
+{
+	parents[index] = TRANSFORM_NO_INDEX;
+	owners[index] = nullptr;
+	freeSlots.push_back(index);
+
+	// Compact once over half the slots are holes
+	if (freeSlots.size() * 2 > owners.size()) orderDirty = true;
+}
+
+/// <summary>
+/// Sets a slot's parent. Only marks the order for re-sorting, so
+/// reparenting many transforms in a frame costs one sort.
+/// </summary>
+/// <param name="index">Child's slot</param>
+/// <param name="parentIndex">Parent's slot, or TRANSFORM_NO_INDEX for none</param>
+void TransformHierarchy::SetParent(uint32_t index, uint32_t parentIndex)
+{
+	if (parents[index] == parentIndex) return;
+
+	parents[index] = parentIndex;
+	MarkChanged(index);
+	levelsDirty = true;
+	if (parentIndex != TRANSFORM_NO_INDEX && parentIndex > index) orderDirty = true;
+}
+
+/// <summary>
+/// Marks a slot's local transform as changed. Its descendants see the change
+/// through its world version once its world matrix is rebuilt.
+/// </summary>
+void TransformHierarchy::MarkChanged(uint32_t index)
+{
+	localVersions[index]++;
+	changeCount++;
+}
+
+/// <summary>
+/// Whether a slot's world matrix is out of date, checking ancestors as needed.
+/// Doesn't rebuild anything.
+/// </summary>
+bool TransformHierarchy::IsStale(uint32_t index)
+{
+	if (verifiedAt[index] == changeCount) return false;
+	if (localVersions[index] != builtLocalVersions[index]) return true;
+
+	uint32_t parent = parents[index];
+	if (parent == TRANSFORM_NO_INDEX) return false;
+	return IsStale(parent) || worldVersions[parent] != builtParentVersions[index];
+}
+
+/// <summary>
+/// Brings one world matrix up to date right away, and any out of date ancestors
+/// with it. Used by getters between passes, and works whatever the current order.
+/// Costs one comparison if nothing has changed since the last check.
+/// </summary>
+void TransformHierarchy::UpdateWorldMatrix(uint32_t index)
+{
+	if (verifiedAt[index] == changeCount) return;
+
+	uint32_t parent = parents[index];
+	if (parent != TRANSFORM_NO_INDEX) UpdateWorldMatrix(parent);
+
+	if (localVersions[index] != builtLocalVersions[index] || (parent != TRANSFORM_NO_INDEX && worldVersions[parent] != builtParentVersions[index])) {
+		ComputeWorldMatrix(index);
+	}
+	verifiedAt[index] = changeCount;
+}
+
+/// <summary>
+/// Scale, then rotation, then translation, then the parent's world matrix.
+/// The world rotation is the local rotation followed by the parent's,
+/// and the world scale the local scale times the parent's.
+/// The parent's world matrix, rotation and scale must already be up to date.
+/// </summary>
+void TransformHierarchy::ComputeWorldMatrix(uint32_t index)
+{
+	// Scaling the rotation's rows and writing the translation row is
+	// the same as multiplying by scale and translation matrices
+	XMVECTOR rotation = XMLoadFloat4(&localRotations[index]);
+	XMVECTOR scale = XMLoadFloat3(&localScales[index]);
+	XMMATRIX world = XMMatrixRotationQuaternion(rotation);
+	world.r[0] = XMVectorMultiply(world.r[0], XMVectorSplatX(scale));
+	world.r[1] = XMVectorMultiply(world.r[1], XMVectorSplatY(scale));
+	world.r[2] = XMVectorMultiply(world.r[2], XMVectorSplatZ(scale));
+	world.r[3] = XMVectorSetW(XMLoadFloat3(&localPositions[index]), 1.0f);
+
+	uint32_t parent = parents[index];
+	if (parent != TRANSFORM_NO_INDEX) {
+		world = XMMatrixMultiply(world, XMLoadFloat4x4A(&worldMatrices[parent]));
+		rotation = XMQuaternionMultiply(rotation, XMLoadFloat4(&worldRotations[parent]));
+		scale = XMVectorMultiply(scale, XMLoadFloat3(&worldScales[parent]));
+	}
+
+	XMStoreFloat4x4A(&worldMatrices[index], world);
+	XMStoreFloat4(&worldRotations[index], rotation);
+	XMStoreFloat3(&worldScales[index], scale);
+
+	worldVersions[index]++;
+	builtLocalVersions[index] = localVersions[index];
+	builtParentVersions[index] = parent != TRANSFORM_NO_INDEX ? worldVersions[parent] : 0;
+}
+
+/// <summary>
+/// Brings one inverse transpose up to date, and the world matrix it comes from
+/// </summary>
+void TransformHierarchy::UpdateInverseTranspose(uint32_t index)
+{
+	UpdateWorldMatrix(index);
+	if (inverseTransposeVersions[index] != worldVersions[index]) ComputeInverseTranspose(index);
+}
+
+/// <summary>
+/// Brings the inverse transposes of many transforms up to date at once, such as
+/// everything about to be drawn. With enough of them, and more than one hardware
+/// thread, the stale ones are gathered first and then worked out across the
+/// SystemScheduler's workers. Otherwise each is worked out as it's found.
+/// Main thread only.
+/// </summary>
+void TransformHierarchy::UpdateInverseTransposes(const std::vector<Transform*>& transforms)
+{
+	bool parallel = transforms.size() >= ParallelThreshold && std::thread::hardware_concurrency() > 1;
+
+	staleInverseTransposes.clear();
+	for (Transform* transform : transforms) {
+		uint32_t index = transform->hierarchyIndex;
+		if (index == TRANSFORM_NO_INDEX) continue;
+
+		UpdateWorldMatrix(index);
+		if (inverseTransposeVersions[index] == worldVersions[index]) continue;
+
+		if (parallel) {
+			// Stamped here so a transform listed twice is only gathered once
+			inverseTransposeVersions[index] = worldVersions[index];
+			staleInverseTransposes.push_back(index);
+		}
+		else {
+			ComputeInverseTranspose(index);
+		}
+	}
+
+	uint32_t count = (uint32_t)staleInverseTransposes.size();
+	if (count == 0) return;
+
+	uint32_t chunks = (count + ChunkSize - 1) / ChunkSize;
+	SystemScheduler::GetInstance().ParallelFor(chunks, [count](size_t chunk) {
+		uint32_t begin = (uint32_t)chunk * ChunkSize;
+		uint32_t end = std::min<uint32_t>(begin + ChunkSize, count);
+		for (uint32_t i = begin; i < end; i++) {
+			ComputeInverseTranspose(staleInverseTransposes[i]);
+		}
+	});
+}
+
+/// <summary>
+/// Inverts and transposes the world matrix without a general 4x4 inverse.
+/// The world matrix is affine, so the inverse transpose of its upper 3x3 is the
+/// cofactor matrix over the determinant. Each cofactor row is the cross product
+/// of the other two basis rows. The last column undoes the translation, and
+/// the last row is left as (0, 0, 0, 1). This holds for any affine matrix, so
+/// unlike the composed rotation and scale it stays exact under shear.
+/// The world matrix must already be up to date.
+/// </summary>
+void TransformHierarchy::ComputeInverseTranspose(uint32_t index)
+{
+	XMMATRIX world = XMLoadFloat4x4A(&worldMatrices[index]);
+
+	XMMATRIX inverseTranspose;
+	inverseTranspose.r[0] = XMVector3Cross(world.r[1], world.r[2]);
+	inverseTranspose.r[1] = XMVector3Cross(world.r[2], world.r[0]);
+	inverseTranspose.r[2] = XMVector3Cross(world.r[0], world.r[1]);
+
+	XMVECTOR inverseDeterminant = XMVectorReciprocal(XMVector3Dot(world.r[0], inverseTranspose.r[0]));
+	XMVECTOR translation = XMVectorNegate(world.r[3]);
+	for (int i = 0; i < 3; i++) {
+		XMVECTOR row = XMVectorMultiply(inverseTranspose.r[i], inverseDeterminant);
+		inverseTranspose.r[i] = XMVectorSetW(row, XMVectorGetX(XMVector3Dot(translation, row)));
+	}
+	inverseTranspose.r[3] = XMVectorSet(0, 0, 0, 1);
+
+	XMStoreFloat4x4A(&worldInverseTransposes[index], inverseTranspose);
+	inverseTransposeVersions[index] = worldVersions[index];
+}
+
+/// <summary>
+/// Stable sorts the live slots by depth in the hierarchy, which puts every parent
+/// before its children, drops freed slots, and tells each owner its new index
+/// </summary>
+void TransformHierarchy::SortByDepth()
+{
+	const uint32_t unknown = UINT32_MAX;
+	uint32_t count = (uint32_t)owners.size();
+
+	// Each slot's depth, reusing the depths of ancestors already measured
+	sortDepths.assign(count, unknown);
+	uint32_t maxDepth = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (owners[i] == nullptr) continue;
+
+		uint32_t steps = 0;
+		uint32_t ancestor = parents[i];
+		while (ancestor != TRANSFORM_NO_INDEX && sortDepths[ancestor] == unknown) {
+			ancestor = parents[ancestor];
+			steps++;
+		}
+
+		sortDepths[i] = (ancestor == TRANSFORM_NO_INDEX ? 0 : sortDepths[ancestor] + 1) + steps;
+		maxDepth = std::max<uint32_t>(maxDepth, sortDepths[i]);
+	}
+
+	// Counting sort, so slots at the same depth keep their relative order
+	std::vector<uint32_t> depthStarts = std::vector<uint32_t>(maxDepth + 2, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		if (owners[i] != nullptr) depthStarts[sortDepths[i] + 1]++;
+	}
+	for (uint32_t depth = 1; depth < depthStarts.size(); depth++) {
+		depthStarts[depth] += depthStarts[depth - 1];
+	}
+
+	uint32_t liveCount = depthStarts.back();
+	levelStarts.assign(depthStarts.begin(), depthStarts.end() - 1);
+	levelStarts.push_back(liveCount);
+	sortOrder.resize(liveCount);
+	sortNewIndices.assign(count, TRANSFORM_NO_INDEX);
+	for (uint32_t i = 0; i < count; i++) {
+		if (owners[i] == nullptr) continue;
+
+		uint32_t newIndex = depthStarts[sortDepths[i]]++;
+		sortOrder[newIndex] = i;
+		sortNewIndices[i] = newIndex;
+	}
+
+	Permute(localPositions, sortOrder);
+	Permute(localRotations, sortOrder);
+	Permute(localScales, sortOrder);
+	Permute(parents, sortOrder);
+	Permute(worldMatrices, sortOrder);
+	Permute(worldRotations, sortOrder);
+	Permute(worldScales, sortOrder);
+	Permute(worldInverseTransposes, sortOrder);
+	Permute(localVersions, sortOrder);
+	Permute(worldVersions, sortOrder);
+	Permute(builtLocalVersions, sortOrder);
+	Permute(builtParentVersions, sortOrder);
+	Permute(inverseTransposeVersions, sortOrder);
+	Permute(verifiedAt, sortOrder);
+	Permute(owners, sortOrder);
+
+	for (uint32_t i = 0; i < liveCount; i++) {
+		if (parents[i] != TRANSFORM_NO_INDEX) parents[i] = sortNewIndices[parents[i]];
+		owners[i]->hierarchyIndex = i;
+	}
+
+	freeSlots.clear();
+	orderDirty = false;
+	levelsDirty = false;
+}
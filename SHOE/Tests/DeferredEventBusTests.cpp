@@ -0,0 +1,77 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "..\Headers\DeferredEventBus.h"
+
+// Several producers post far more than Capacity while the main thread keeps
+// flushing. Every post must either be drained by a Flush or counted as dropped.
+// Targets are empty, so Flush drains and counts events without needing a scene.
+TEST(DeferredEventBusMultiProducerStress)
+{
+	const int producerCount = 8;
+	const int postsPerProducer = 100000;
+
+	DeferredEventBus& bus = DeferredEventBus::GetInstance();
+	bus.Flush();
+	size_t droppedBefore = bus.GetDroppedCount();
+
+	std::atomic<int> running = producerCount;
+	std::atomic<size_t> accepted = 0;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < producerCount; p++) {
+		producers.emplace_back([&, p]() {
+			size_t producerAccepted = 0;
+			for (int i = 0; i < postsPerProducer; i++) {
+				EntityEventMessage message = EntityEventMessage(DirectX::XMFLOAT3((float)p, (float)i, 0.0f));
+				if (DeferredEventBus::GetInstance().PostTo(std::weak_ptr<GameEntity>(), OnMove, message)) producerAccepted++;
+			}
+			accepted += producerAccepted;
+			running--;
+		});
+	}
+
+	// Let the ring overflow before draining anything, so the full path is certain to run
+	while (bus.GetDroppedCount() == droppedBefore && running > 0) {
+		std::this_thread::yield();
+	}
+
+	size_t delivered = 0;
+	size_t flushes = 0;
+	while (running > 0) {
+		bus.Flush();
+		delivered += bus.GetLastFlushCount();
+		flushes++;
+		std::this_thread::yield();
+	}
+
+	for (std::thread& producer : producers) {
+		producer.join();
+	}
+	bus.Flush();
+	delivered += bus.GetLastFlushCount();
+
+	size_t posted = (size_t)producerCount * postsPerProducer;
+	size_t dropped = bus.GetDroppedCount() - droppedBefore;
+	printf("    %zu posted, %zu delivered, %zu dropped over %zu flushes\n", posted, delivered, dropped, flushes);
+
+	CHECK(dropped > 0);
+	CHECK(delivered == accepted);
+	CHECK(delivered + dropped == posted);
+	CHECK(bus.GetPendingCount() == 0);
+}
+
+// Rejected posts aren't drops, and nothing is queued for them
+TEST(DeferredEventBusRejectsWrongPayloads)
+{
+	DeferredEventBus& bus = DeferredEventBus::GetInstance();
+	bus.Flush();
+	size_t droppedBefore = bus.GetDroppedCount();
+
+	CHECK(!bus.PostTo(std::weak_ptr<GameEntity>(), OnMove));
+	CHECK(!bus.PostTo(std::weak_ptr<GameEntity>(), OnCollisionEnter, EntityEventMessage((GameEntity*)nullptr)));
+	CHECK(bus.GetDroppedCount() == droppedBefore);
+	CHECK(bus.GetPendingCount() == 0);
+}
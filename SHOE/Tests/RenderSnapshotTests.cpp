@@ -0,0 +1,163 @@
+#include "TestFramework.h"
+
+#include <cmath>
+
+#include "..\Headers\RenderSnapshot.h"
+
+using namespace DirectX;
+
+static bool Near(float a, float b)
+{
+	return fabsf(a - b) < 0.0001f;
+}
+
+// A renderer at x along the X axis, turned angle radians about Y and uniformly scaled
+static RenderSnapshotItem MakeItem(uint32_t slot, uint32_t generation, float x, float angle, float scale)
+{
+	RenderSnapshotItem item = {};
+	item.meshRenderer = ComponentHandle::Make(slot, generation);
+	item.position = XMFLOAT3(x, 0.0f, 0.0f);
+	XMStoreFloat4(&item.rotation, XMQuaternionRotationRollPitchYaw(0.0f, angle, 0.0f));
+	item.scale = XMFLOAT3(scale, scale, scale);
+
+	XMMATRIX world = XMMatrixAffineTransformation(XMLoadFloat3(&item.scale), XMVectorZero(), XMLoadFloat4(&item.rotation), XMLoadFloat3(&item.position));
+	XMStoreFloat4x4(&item.world, world);
+	XMStoreFloat4x4(&item.worldInverseTranspose, XMMatrixTranspose(XMMatrixInverse(nullptr, world)));
+	item.bounds.Center = item.position;
+	item.bounds.Extents = item.scale;
+	item.bounds.Orientation = item.rotation;
+	return item;
+}
+
+// Takes anything already published, so each test starts with nothing waiting
+static void DrainBuffer(RenderSnapshotBuffer& buffer)
+{
+	buffer.Acquire();
+}
+
+// The renderer gets the newest publish, an unconsumed publish is written over,
+// and the write snapshot never aliases what the renderer holds
+TEST(RenderSnapshotBufferRotatesSlots)
+{
+	RenderSnapshotBuffer& buffer = RenderSnapshotBuffer::GetInstance();
+	DrainBuffer(buffer);
+
+	CHECK(!buffer.Acquire());
+
+	buffer.GetWriteSnapshot().Clear();
+	buffer.GetWriteSnapshot().frame = 1001;
+	buffer.Publish();
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetCurrent());
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetPrevious());
+
+	CHECK(buffer.Acquire());
+	CHECK(buffer.GetCurrent().frame == 1001);
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetCurrent());
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetPrevious());
+
+	// 1002 is never acquired, so 1003 takes its place
+	buffer.GetWriteSnapshot().Clear();
+	buffer.GetWriteSnapshot().frame = 1002;
+	buffer.Publish();
+	buffer.GetWriteSnapshot().Clear();
+	buffer.GetWriteSnapshot().frame = 1003;
+	buffer.Publish();
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetCurrent());
+	CHECK(&buffer.GetWriteSnapshot() != &buffer.GetPrevious());
+
+	CHECK(buffer.Acquire());
+	CHECK(buffer.GetCurrent().frame == 1003);
+	CHECK(buffer.GetPrevious().frame == 1001);
+
+	// Nothing new, so both are kept
+	CHECK(!buffer.Acquire());
+	CHECK(buffer.GetCurrent().frame == 1003);
+	CHECK(buffer.GetPrevious().frame == 1001);
+}
+
+// Renderers in both snapshots blend, while a renderer whose slot was reused
+// in between and one new in the current snapshot are taken as is
+TEST(RenderSnapshotInterpolatesMatchingRenderers)
+{
+	RenderSnapshotBuffer& buffer = RenderSnapshotBuffer::GetInstance();
+	DrainBuffer(buffer);
+
+	RenderSnapshot& from = buffer.GetWriteSnapshot();
+	from.Clear();
+	from.frame = 2001;
+	from.time = 1.0f;
+	from.items.push_back(MakeItem(3, 1, 0.0f, 0.0f, 1.0f));
+	from.items.push_back(MakeItem(5, 1, 0.0f, 0.0f, 1.0f));
+	buffer.Publish();
+	buffer.Acquire();
+
+	RenderSnapshot& to = buffer.GetWriteSnapshot();
+	to.Clear();
+	to.frame = 2002;
+	to.time = 2.0f;
+	// Listed in a different order than before, as a re-sort would
+	to.items.push_back(MakeItem(7, 1, 30.0f, 0.0f, 1.0f));
+	to.items.push_back(MakeItem(5, 2, 20.0f, 0.0f, 1.0f));
+	to.items.push_back(MakeItem(3, 1, 10.0f, XM_PIDIV2, 3.0f));
+	to.lightCount = 1;
+	to.lights[0].range = 42.0f;
+	buffer.Publish();
+	buffer.Acquire();
+
+	CHECK(Near(buffer.GetAlpha(1.5f), 0.5f));
+	CHECK(Near(buffer.GetAlpha(0.0f), 0.0f));
+	CHECK(Near(buffer.GetAlpha(5.0f), 1.0f));
+
+	const RenderSnapshot& current = buffer.GetCurrent();
+	CHECK(&buffer.GetInterpolated(1.0f) == &current);
+
+	const RenderSnapshot& halfway = buffer.GetInterpolated(0.5f);
+	CHECK(&halfway != &current);
+	CHECK(halfway.frame == 2002);
+	CHECK(halfway.items.size() == 3);
+	CHECK(halfway.lightCount == 1);
+	CHECK(Near(halfway.lights[0].range, 42.0f));
+	if (halfway.items.size() != 3) return;
+
+	// New renderer
+	CHECK(Near(halfway.items[0].position.x, 30.0f));
+
+	// Same slot, different generation: another renderer, so no blending
+	CHECK(halfway.items[1].meshRenderer == ComponentHandle::Make(5, 2));
+	CHECK(Near(halfway.items[1].position.x, 20.0f));
+	CHECK(Near(halfway.items[1].world._41, 20.0f));
+
+	// Blended halfway in position, scale and rotation
+	RenderSnapshotItem expected = MakeItem(3, 1, 5.0f, XM_PIDIV4, 2.0f);
+	const RenderSnapshotItem& blended = halfway.items[2];
+	CHECK(Near(blended.position.x, 5.0f));
+	CHECK(Near(blended.scale.y, 2.0f));
+	CHECK(Near(fabsf(XMVectorGetX(XMQuaternionDot(XMLoadFloat4(&blended.rotation), XMLoadFloat4(&expected.rotation)))), 1.0f));
+	for (int i = 0; i < 16; i++) {
+		CHECK(Near((&blended.world._11)[i], (&expected.world._11)[i]));
+		CHECK(Near((&blended.worldInverseTranspose._11)[i], (&expected.worldInverseTranspose._11)[i]));
+	}
+	CHECK(Near(blended.bounds.Center.x, 5.0f));
+	CHECK(Near(blended.bounds.Extents.z, 2.0f));
+
+	// The blend never writes into the snapshots it reads
+	CHECK(Near(current.items[2].position.x, 10.0f));
+	CHECK(Near(buffer.GetPrevious().items[0].position.x, 0.0f));
+}
+
+// Snapshots captured at the same time have nothing to blend between
+TEST(RenderSnapshotAlphaWithoutElapsedTime)
+{
+	RenderSnapshotBuffer& buffer = RenderSnapshotBuffer::GetInstance();
+	DrainBuffer(buffer);
+
+	for (int i = 0; i < 2; i++) {
+		buffer.GetWriteSnapshot().Clear();
+		buffer.GetWriteSnapshot().time = 3.0f;
+		buffer.Publish();
+		buffer.Acquire();
+	}
+
+	CHECK(Near(buffer.GetAlpha(2.0f), 1.0f));
+	CHECK(&buffer.GetInterpolated(buffer.GetAlpha(2.0f)) == &buffer.GetCurrent());
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+// Minimal headless test runner. Each TEST registers itself before main runs,
+// and CHECK records a failure without stopping the rest of the test.
+
+struct TestCase
+{
+	const char* name;
+	void (*run)();
+};
+
+std::vector<TestCase>& GetTestCases();
+void ReportCheckFailure(const char* expression, const char* file, int line);
+
+struct TestRegistration
+{
+	TestRegistration(const char* name, void (*run)()) { GetTestCases().push_back(TestCase{ name, run }); }
+};
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistration name##Registration(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) ReportCheckFailure(#expression, __FILE__, __LINE__); } while (false)
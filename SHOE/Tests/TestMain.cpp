@@ -0,0 +1,44 @@
+#include "TestFramework.h"
+
+#include <cstring>
+
+namespace {
+	int currentFailures = 0;
+}
+
+std::vector<TestCase>& GetTestCases()
+{
+	// Function local so registrations from any file can run first
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+void ReportCheckFailure(const char* expression, const char* file, int line)
+{
+	printf("    %s(%d): CHECK(%s) failed\n", file, line, expression);
+	currentFailures++;
+}
+
+// --------------------------------------------------------
+// Runs every registered test, or only those whose names
+// contain the first argument. Returns the number that failed.
+// --------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	int run = 0;
+	int failed = 0;
+
+	for (const TestCase& test : GetTestCases()) {
+		if (filter != nullptr && strstr(test.name, filter) == nullptr) continue;
+
+		printf("%s\n", test.name);
+		currentFailures = 0;
+		test.run();
+		run++;
+		if (currentFailures > 0) failed++;
+	}
+
+	printf("%d of %d tests passed\n", run - failed, run);
+	return failed;
+}